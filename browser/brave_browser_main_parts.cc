@@ -6,16 +6,22 @@
 #include "brave/browser/brave_browser_main_parts.h"
 
 #include "base/command_line.h"
+#include "brave/browser/brave_browser_process_impl.h"
 #include "brave/browser/browsing_data/brave_clear_browsing_data.h"
 #include "brave/browser/tor/buildflags.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_sync/features.h"
+#include "brave/components/p3a/buildflags.h"
 #include "chrome/common/chrome_features.h"
 #include "components/prefs/pref_service.h"
 #include "components/sync/driver/sync_driver_switches.h"
 #include "content/public/browser/render_frame_host.h"
 #include "media/base/media_switches.h"
 
+#if BUILDFLAG(BRAVE_P3A_ENABLED)
+#include "brave/components/p3a/brave_p3a_service.h"
+#endif
+
 #if BUILDFLAG(ENABLE_TOR)
 #include <string>
 #include "base/files/file_util.h"
@@ -90,6 +96,11 @@ void BraveBrowserMainParts::PostBrowserStart() {
 }
 
 void BraveBrowserMainParts::PreShutdown() {
+#if BUILDFLAG(BRAVE_P3A_ENABLED)
+  // Write P3A values still waiting for their batched write before local
+  // state is committed.
+  g_brave_browser_process->brave_p3a_service()->FlushPendingValues();
+#endif  // BUILDFLAG(BRAVE_P3A_ENABLED)
   content::BraveClearBrowsingData::ClearOnExit();
 }
 
@@ -26,6 +26,7 @@
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/https_everywhere_service.h"
+#include "brave/components/brave_shields/browser/query_filter_service.h"
 #include "brave/components/brave_shields/browser/referrer_whitelist_service.h"
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 #include "brave/components/ntp_background_images/browser/features.h"
@@ -187,6 +188,7 @@ void BraveBrowserProcessImpl::StartBraveServices() {
   extension_whitelist_service();
 #endif
   referrer_whitelist_service();
+  query_filter_service();
   tracking_protection_service();
 #if BUILDFLAG(ENABLE_GREASELION)
   greaselion_download_service();
@@ -250,7 +252,8 @@ BraveBrowserProcessImpl::extension_whitelist_service() {
   if (!extension_whitelist_service_) {
     extension_whitelist_service_ =
         brave_component_updater::ExtensionWhitelistServiceFactory(
-            local_data_files_service(), kVettedExtensions);
+            local_data_files_service(), kVettedExtensions,
+            kBlacklistedExtensions);
   }
   return extension_whitelist_service_.get();
 }
@@ -266,6 +269,15 @@ BraveBrowserProcessImpl::referrer_whitelist_service() {
   return referrer_whitelist_service_.get();
 }
 
+brave_shields::QueryFilterService*
+BraveBrowserProcessImpl::query_filter_service() {
+  if (!query_filter_service_) {
+    query_filter_service_ =
+        brave_shields::QueryFilterServiceFactory(local_data_files_service());
+  }
+  return query_filter_service_.get();
+}
+
 #if BUILDFLAG(ENABLE_GREASELION)
 greaselion::GreaselionDownloadService*
 BraveBrowserProcessImpl::greaselion_download_service() {
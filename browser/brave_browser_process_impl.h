@@ -40,6 +40,7 @@ class AdBlockService;
 class AdBlockCustomFiltersService;
 class AdBlockRegionalServiceManager;
 class HTTPSEverywhereService;
+class QueryFilterService;
 class ReferrerWhitelistService;
 class TrackingProtectionService;
 }  // namespace brave_shields
@@ -82,6 +83,7 @@ class BraveBrowserProcessImpl : public BrowserProcessImpl {
   extension_whitelist_service();
 #endif
   brave_shields::ReferrerWhitelistService* referrer_whitelist_service();
+  brave_shields::QueryFilterService* query_filter_service();
 #if BUILDFLAG(ENABLE_GREASELION)
   greaselion::GreaselionDownloadService* greaselion_download_service();
 #endif
@@ -136,6 +138,7 @@ class BraveBrowserProcessImpl : public BrowserProcessImpl {
 #endif
   std::unique_ptr<brave_shields::ReferrerWhitelistService>
       referrer_whitelist_service_;
+  std::unique_ptr<brave_shields::QueryFilterService> query_filter_service_;
 #if BUILDFLAG(ENABLE_GREASELION)
   std::unique_ptr<greaselion::GreaselionDownloadService>
       greaselion_download_service_;
@@ -66,9 +66,10 @@ void BaseLocalDataFilesBrowserTest::MaybeSetUpEmbeddedTestServerOnMainThread() {
 }
 
 void BaseLocalDataFilesBrowserTest::WaitForService() {
-  scoped_refptr<base::ThreadTestHelper> tr_helper(new base::ThreadTestHelper(
-      g_brave_browser_process->local_data_files_service()->GetTaskRunner()));
-  ASSERT_TRUE(tr_helper->Run());
+  base::RunLoop run_loop;
+  g_brave_browser_process->local_data_files_service()->RunWhenReady(
+      run_loop.QuitClosure());
+  run_loop.Run();
   scoped_refptr<base::ThreadTestHelper> io_helper(new base::ThreadTestHelper(
       base::CreateSingleThreadTaskRunner({BrowserThread::IO}).get()));
   ASSERT_TRUE(io_helper->Run());
@@ -5,9 +5,7 @@
 
 #include "brave/browser/extensions/brave_extension_provider.h"
 
-#include <algorithm>
 #include <string>
-#include <vector>
 
 #include "base/strings/utf_string_conversions.h"
 #include "brave/browser/brave_browser_process_impl.h"
@@ -20,19 +18,6 @@
 namespace {
 
 bool IsBlacklisted(const extensions::Extension* extension) {
-  // This is a hardcoded list of extensions to block.
-  // Don't add new extensions to this list. Add them to
-  // the files managed by the extension whitelist service.
-  static std::vector<std::string> blacklisted_extensions(
-      {// Used for tests, corresponds to
-       // brave/test/data/should-be-blocked-extension.
-       "mlklomjnahgiddgfdgjhibinlfibfffc",
-     });
-
-  if (std::find(blacklisted_extensions.begin(), blacklisted_extensions.end(),
-                extension->id()) != blacklisted_extensions.end())
-    return true;
-
   return g_brave_browser_process->extension_whitelist_service()->IsBlacklisted(
       extension->id());
 }
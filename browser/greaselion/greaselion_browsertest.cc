@@ -3,10 +3,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
 #include "base/path_service.h"
 #include "base/run_loop.h"
 #include "base/task/post_task.h"
 #include "base/test/thread_test_helper.h"
+#include "base/threading/thread_restrictions.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/browser/extensions/brave_base_local_data_files_browsertest.h"
 #include "brave/browser/greaselion/greaselion_service_factory.h"
@@ -15,9 +18,11 @@
 #include "brave/components/brave_rewards/browser/rewards_service_factory.h"
 #include "brave/components/greaselion/browser/greaselion_download_service.h"
 #include "brave/components/greaselion/browser/greaselion_service.h"
+#include "brave/components/greaselion/browser/greaselion_service_impl.h"
 #include "chrome/browser/extensions/extension_browsertest.h"
 #include "chrome/test/base/ui_test_utils.h"
 #include "content/public/test/browser_test_utils.h"
+#include "extensions/common/constants.h"
 #include "net/dns/mock_host_resolver.h"
 
 using brave_rewards::RewardsService;
@@ -26,6 +31,7 @@ using extensions::ExtensionBrowserTest;
 using greaselion::GreaselionDownloadService;
 using greaselion::GreaselionService;
 using greaselion::GreaselionServiceFactory;
+using greaselion::GreaselionServiceImpl;
 
 const char kTestDataDirectory[] = "greaselion-data";
 const char kEmbeddedTestServerDirectory[] = "greaselion";
@@ -120,6 +126,12 @@ class GreaselionServiceTest : public BaseLocalDataFilesBrowserTest {
     g_brave_browser_process->greaselion_download_service()->rules()->clear();
   }
 
+  int GetConvertedRulesCount() {
+    return static_cast<GreaselionServiceImpl*>(
+               GreaselionServiceFactory::GetForBrowserContext(profile()))
+        ->converted_rules_count_for_testing();
+  }
+
   void SetRewardsEnabled(bool enabled) {
     RewardsService* rewards_service =
         RewardsServiceFactory::GetForProfile(profile());
@@ -250,3 +262,59 @@ IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, ScriptInjectionWithPrecondition) {
   // Greaselion rule is active
   EXPECT_EQ(title, "Altered");
 }
+
+// Ensure rules are converted to extensions only once per rule contents, so
+// that toggling a feature reuses the extensions converted before.
+IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, ConvertedExtensionsAreCached) {
+  ASSERT_TRUE(InstallMockExtension());
+  const int initial_count = GetConvertedRulesCount();
+  EXPECT_GT(initial_count, 0);
+
+  // Only the rule with the rewards precondition is new.
+  SetRewardsEnabled(true);
+  EXPECT_EQ(initial_count + 1, GetConvertedRulesCount());
+
+  SetRewardsEnabled(false);
+  SetRewardsEnabled(true);
+  EXPECT_EQ(initial_count + 1, GetConvertedRulesCount());
+
+  // Reloading the same rules doesn't convert them again either.
+  ASSERT_TRUE(InstallMockExtension());
+  EXPECT_EQ(initial_count + 1, GetConvertedRulesCount());
+}
+
+// Ensure a cached extension which can't be loaded, e.g. because it lost its
+// manifest, is replaced instead of blocking its rule forever.
+IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, BrokenCacheEntriesAreReplaced) {
+  ASSERT_TRUE(InstallMockExtension());
+  const int initial_count = GetConvertedRulesCount();
+  EXPECT_GT(initial_count, 0);
+
+  int broken_count = 0;
+  const base::FilePath cache_dir =
+      profile()->GetPath().Append(FILE_PATH_LITERAL("Greaselion"));
+  {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    base::FileEnumerator enumerator(cache_dir, false,
+                                    base::FileEnumerator::DIRECTORIES);
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      ASSERT_TRUE(base::DeleteFile(
+          path.Append(extensions::kManifestFilename), false));
+      broken_count++;
+    }
+  }
+  EXPECT_EQ(initial_count, broken_count);
+
+  // Reloading the rules converts every broken one again.
+  ASSERT_TRUE(InstallMockExtension());
+  EXPECT_EQ(initial_count + broken_count, GetConvertedRulesCount());
+
+  base::ScopedAllowBlockingForTesting allow_blocking;
+  base::FileEnumerator enumerator(cache_dir, false,
+                                  base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    EXPECT_TRUE(base::PathExists(path.Append(extensions::kManifestFilename)));
+  }
+}
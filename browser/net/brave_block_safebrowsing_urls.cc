@@ -7,6 +7,8 @@
 
 #include <vector>
 
+#include "base/no_destructor.h"
+#include "brave/common/host_indexed_url_pattern_set.h"
 #include "extensions/common/url_pattern.h"
 #include "net/base/net_errors.h"
 #include "url/gurl.h"
@@ -16,19 +18,19 @@ namespace brave {
 const char kDummyUrl[] = "https://no-thanks.invalid";
 
 bool IsSafeBrowsingReportingURL(const GURL& gurl) {
-  static const std::vector<URLPattern> reporting_patterns({
-      URLPattern(URLPattern::SCHEME_HTTPS,
-                 "https://sb-ssl.google.com/safebrowsing/clientreport/*"),
-      URLPattern(URLPattern::SCHEME_HTTPS,
-                 "https://safebrowsing.google.com/safebrowsing/clientreport/*"),
-      URLPattern(URLPattern::SCHEME_HTTPS,
-                 "https://safebrowsing.google.com/safebrowsing/report*"),
-      URLPattern(URLPattern::SCHEME_HTTPS,
-                 "https://safebrowsing.google.com/safebrowsing/uploads/*"),
-  });
-  return std::any_of(
-      reporting_patterns.begin(), reporting_patterns.end(),
-      [&gurl](URLPattern pattern) { return pattern.MatchesURL(gurl); });
+  static const base::NoDestructor<HostIndexedURLPatternSet> reporting_patterns(
+      std::vector<URLPattern>({
+          URLPattern(URLPattern::SCHEME_HTTPS,
+                     "https://sb-ssl.google.com/safebrowsing/clientreport/*"),
+          URLPattern(
+              URLPattern::SCHEME_HTTPS,
+              "https://safebrowsing.google.com/safebrowsing/clientreport/*"),
+          URLPattern(URLPattern::SCHEME_HTTPS,
+                     "https://safebrowsing.google.com/safebrowsing/report*"),
+          URLPattern(URLPattern::SCHEME_HTTPS,
+                     "https://safebrowsing.google.com/safebrowsing/uploads/*"),
+      }));
+  return reporting_patterns->MatchesURL(gurl);
 }
 
 int OnBeforeURLRequest_BlockSafeBrowsingReportingURLs(const GURL& request_url,
@@ -25,6 +25,11 @@ const char kThirdPartyDomain[] = "http://thirdparty.com/";
 const char kAcceptLanguageHeader[] = "Accept-Language";
 const char kXSSProtectionHeader[] = "X-XSS-Protection";
 
+const char kRawHeadersWithoutTrackableHeaders[] =
+    "HTTP/1.0 200 OK\n"
+    "Accept-Language: *\n"
+    "X-XSS-Protection: 0";
+
 const char kRawHeaders[] =
     "HTTP/1.0 200 OK\n"
     "Strict-Transport-Security: max-age=31557600\n"
@@ -107,4 +112,54 @@ TEST_F(BraveNetworkDelegateBaseTest, RetainTrackableSecurityHeaders) {
   EXPECT_TRUE(headers->HasHeader(kXSSProtectionHeader));
 }
 
+TEST_F(BraveNetworkDelegateBaseTest,
+       RemoveTrackableSecurityHeadersFromOriginal) {
+  GURL request_url(kThirdPartyDomain);
+  GURL tab_url(kFirstPartyDomain);
+
+  scoped_refptr<HttpResponseHeaders> original_headers(
+      new HttpResponseHeaders(net::HttpUtil::AssembleRawHeaders(kRawHeaders)));
+  scoped_refptr<HttpResponseHeaders> override_headers;
+
+  RemoveTrackableSecurityHeadersForThirdParty(request_url,
+                                              url::Origin::Create(tab_url),
+                                              original_headers.get(),
+                                              &override_headers);
+  ASSERT_TRUE(override_headers);
+  for (auto header : *TrackableSecurityHeaders()) {
+    EXPECT_TRUE(original_headers->HasHeader(header.as_string()));
+    EXPECT_FALSE(override_headers->HasHeader(header.as_string()));
+  }
+  EXPECT_TRUE(override_headers->HasHeader(kAcceptLanguageHeader));
+  EXPECT_TRUE(override_headers->HasHeader(kXSSProtectionHeader));
+}
+
+TEST_F(BraveNetworkDelegateBaseTest, NoCopyWithoutTrackableSecurityHeaders) {
+  GURL request_url(kThirdPartyDomain);
+  GURL tab_url(kFirstPartyDomain);
+
+  scoped_refptr<HttpResponseHeaders> original_headers(new HttpResponseHeaders(
+      net::HttpUtil::AssembleRawHeaders(kRawHeadersWithoutTrackableHeaders)));
+  scoped_refptr<HttpResponseHeaders> override_headers;
+
+  // No override headers are allocated when there is nothing to remove.
+  RemoveTrackableSecurityHeadersForThirdParty(request_url,
+                                              url::Origin::Create(tab_url),
+                                              original_headers.get(),
+                                              &override_headers);
+  EXPECT_FALSE(override_headers);
+
+  // Existing override headers are kept as is.
+  override_headers = new HttpResponseHeaders(
+      net::HttpUtil::AssembleRawHeaders(kRawHeadersWithoutTrackableHeaders));
+  HttpResponseHeaders* override_headers_ptr = override_headers.get();
+  const std::string raw_headers = override_headers->raw_headers();
+  RemoveTrackableSecurityHeadersForThirdParty(request_url,
+                                              url::Origin::Create(tab_url),
+                                              original_headers.get(),
+                                              &override_headers);
+  EXPECT_EQ(override_headers_ptr, override_headers.get());
+  EXPECT_EQ(raw_headers, override_headers->raw_headers());
+}
+
 }  // namespace
@@ -10,8 +10,12 @@
 #include <utility>
 #include <vector>
 
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
+#include "brave/components/brave_shields/browser/query_filter_service.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using brave::ResponseCallback;
@@ -170,6 +174,10 @@ TEST(BraveSiteHacksNetworkDelegateHelperTest, QueryStringUntouched) {
       "https://example.com/?+fbclid=1",
       "https://example.com/?%20fbclid=1",
       "https://example.com/#fbclid=1",
+      // Encoded separators are part of the parameter they are in.
+      "https://example.com/?q=a%26fbclid%3D1",
+      "https://example.com/?fbclid%3D1",
+      "https://example.com/?fbclid%3d1&gclid%26=2",
   });
   for (const auto& url : urls) {
     auto brave_request_info =
@@ -207,6 +215,12 @@ TEST(BraveSiteHacksNetworkDelegateHelperTest, QueryStringFiltered) {
            "https://example.com/?=2&?foo=yes&bar=2+"},
           {"https://example.com/?fbclid=1&a+b+c=some%20thing&1%202=3+4",
            "https://example.com/?a+b+c=some%20thing&1%202=3+4"},
+          {"https://example.com/?FBCLID=1&foo=1&GClid=2",
+           "https://example.com/?foo=1"},
+          {"https://example.com/?foo=1&&fbclid=1&&gclid=2&&bar=2",
+           "https://example.com/?foo=1&&&&bar=2"},
+          {"https://example.com/?q=a%26b&fbclid=1%262",
+           "https://example.com/?q=a%26b"},
       });
   for (const auto& pair : urls) {
     auto brave_request_info =
@@ -217,3 +231,82 @@ TEST(BraveSiteHacksNetworkDelegateHelperTest, QueryStringFiltered) {
     EXPECT_EQ(brave_request_info->new_url_spec, pair.second);
   }
 }
+
+TEST(BraveSiteHacksNetworkDelegateHelperTest, QueryStringFilterCorpus) {
+  // Real-world shaped URLs, as seen on outbound links from social media,
+  // search ads and newsletters.
+  const std::vector<const std::pair<const std::string, const std::string>> urls(
+      {
+          // { original url, expected url after filtering, empty if untouched }
+          {"https://www.nytimes.com/2020/01/01/world/article.html?"
+           "fbclid=IwAR2vKXm0jS1cHhG6Hvl8Yp3q2-q9bV0YyRkZ1cqU5oY3pN3o",
+           "https://www.nytimes.com/2020/01/01/world/article.html"},
+          {"https://www.example-shop.com/product/123?utm_source=google&"
+           "utm_medium=cpc&gclid=EAIaIQobChMI8Pjd1ovV5gIVxJ7VCh0",
+           "https://www.example-shop.com/product/123?utm_source=google&"
+           "utm_medium=cpc"},
+          {"https://store.example.com/deals?msclkid=5b1e7a0f8e6c1d2a3b4c&"
+           "utm_campaign=spring&utm_content=text%20ad",
+           "https://store.example.com/deals?utm_campaign=spring&"
+           "utm_content=text%20ad"},
+          {"https://blog.example.org/post?mc_cid=2c3e4f5a6b&mc_eid=7d8e9f0a1b",
+           "https://blog.example.org/post?mc_cid=2c3e4f5a6b"},
+          {"https://www.youtube.com/watch?v=dQw4w9WgXcQ&fbclid=IwAR0abc&t=42",
+           "https://www.youtube.com/watch?v=dQw4w9WgXcQ&t=42"},
+          {"https://www.google.com/search?q=fbclid%3D1&oq=fbclid%3D1", ""},
+          {"https://en.wikipedia.org/wiki/Tracking?action=edit&section=1", ""},
+          {"https://docs.example.com/view?file=https%3A%2F%2Fcdn.example.com%2F"
+           "doc.pdf%3Ffbclid%3D1&page=2",
+           ""},
+          {"https://www.amazon.com/dp/B07XYZ/ref=sr_1_1?keywords=usb+cable&"
+           "qid=1577836800&sr=8-1",
+           ""},
+          {"https://m.example.com/a/b/c.html?gclid=abc#section-2",
+           "https://m.example.com/a/b/c.html#section-2"},
+      });
+  for (const auto& pair : urls) {
+    auto brave_request_info =
+        std::make_shared<brave::BraveRequestInfo>(GURL(pair.first));
+    int rc = brave::OnBeforeURLRequest_SiteHacksWork(ResponseCallback(),
+                                                     brave_request_info);
+    EXPECT_EQ(rc, net::OK);
+    EXPECT_EQ(brave_request_info->new_url_spec, pair.second);
+  }
+}
+
+TEST(BraveSiteHacksNetworkDelegateHelperTest, QueryFilterFromComponent) {
+  EXPECT_FALSE(brave_shields::QueryFilter::Parse(""));
+  EXPECT_FALSE(brave_shields::QueryFilter::Parse("[]"));
+  EXPECT_FALSE(brave_shields::QueryFilter::Parse("{\"whitelist\": []}"));
+
+  auto query_filter = brave_shields::QueryFilter::Parse(
+      "{\"trackers\": [\"utm_source\", \"UTM_MEDIUM\", \"\", 1]}");
+  ASSERT_TRUE(query_filter);
+  EXPECT_EQ(2u, query_filter->size());
+
+  std::string filtered_query;
+  EXPECT_FALSE(query_filter->Filter("fbclid=1&foo=2", &filtered_query));
+  EXPECT_TRUE(filtered_query.empty());
+  EXPECT_TRUE(query_filter->Filter(
+      "utm_source=news&fbclid=1&utm_medium=email", &filtered_query));
+  EXPECT_EQ("fbclid=1", filtered_query);
+}
+
+TEST(BraveSiteHacksNetworkDelegateHelperTest, QueryFilterMissingFromComponent) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath dat_file_path =
+      temp_dir.GetPath().AppendASCII("QueryFilter.json");
+
+  // Component versions without the list fall back to the default one.
+  EXPECT_FALSE(
+      brave_shields::QueryFilterService::LoadQueryFilter(dat_file_path));
+
+  const std::string contents = "{\"trackers\": [\"utm_source\"]}";
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            base::WriteFile(dat_file_path, contents.data(), contents.size()));
+  auto query_filter =
+      brave_shields::QueryFilterService::LoadQueryFilter(dat_file_path);
+  ASSERT_TRUE(query_filter);
+  EXPECT_EQ(1u, query_filter->size());
+}
@@ -5,11 +5,32 @@
 
 #include "brave/browser/net/brave_stp_util.h"
 
+#include <string>
+#include <unordered_set>
+
 #include "base/no_destructor.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 
 namespace brave {
 
+namespace {
+
+bool HasTrackableSecurityHeaders(const net::HttpResponseHeaders& headers) {
+  for (auto header : *TrackableSecurityHeaders()) {
+    if (headers.HasHeader(header))
+      return true;
+  }
+  return false;
+}
+
+const std::unordered_set<std::string>& TrackableSecurityHeaderNames() {
+  static base::NoDestructor<std::unordered_set<std::string>> header_names(
+      TrackableSecurityHeaders()->begin(), TrackableSecurityHeaders()->end());
+  return *header_names;
+}
+
+}  // namespace
+
 base::flat_set<base::StringPiece>* TrackableSecurityHeaders() {
   static base::NoDestructor<base::flat_set<base::StringPiece>>
       kTrackableSecurityHeaders(base::flat_set<base::StringPiece>{
@@ -32,13 +53,19 @@ void RemoveTrackableSecurityHeadersForThirdParty(
     return;
   }
 
+  // Most responses don't set any of these, so only copy the original
+  // headers when there is something to remove.
+  const net::HttpResponseHeaders& headers =
+      override_response_headers->get() ? **override_response_headers
+                                       : *original_response_headers;
+  if (!HasTrackableSecurityHeaders(headers))
+    return;
+
   if (!override_response_headers->get()) {
     *override_response_headers =
         new net::HttpResponseHeaders(original_response_headers->raw_headers());
   }
-  for (auto header : *TrackableSecurityHeaders()) {
-    (*override_response_headers)->RemoveHeader(header.as_string());
-  }
+  (*override_response_headers)->RemoveHeaders(TrackableSecurityHeaderNames());
 }
 
 }  // namespace brave
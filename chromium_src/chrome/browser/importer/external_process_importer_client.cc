@@ -0,0 +1,23 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "chrome/browser/importer/external_process_importer_client.h"
+#include "chrome/browser/importer/in_process_importer_bridge.h"
+#include "chrome/common/importer/importer_bridge.h"
+
+// The client collects the rows of every SetHistoryItems() and SetFavicons()
+// call of the importer until all rows announced for that call arrived, and
+// then hands them to the bridge. It never dropped them afterwards though, so
+// an importer sending several batches had every earlier batch written again.
+// Drop the rows once they were handed over, which lets importers stream
+// large profiles in bounded batches.
+#define SetHistoryItems(ROWS, VISIT_SOURCE) \
+  SetHistoryItems(ROWS, VISIT_SOURCE), ROWS.clear()
+#define SetFavicons(FAVICONS) SetFavicons(FAVICONS), FAVICONS.clear()
+
+#include "../../../../../chrome/browser/importer/external_process_importer_client.cc"  // NOLINT
+
+#undef SetHistoryItems
+#undef SetFavicons
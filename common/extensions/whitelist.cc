@@ -43,3 +43,12 @@ const std::vector<std::string> kVettedExtensions{
     // Chromium PDF Viewer.
     "mhjfbmdgcfjbbpaeojofohoefgiehjai",
 };
+
+// This is a hardcoded list of extensions to block.
+// Don't add new extensions to this list. Add them to
+// the files managed by the extension whitelist service.
+const std::vector<std::string> kBlacklistedExtensions{
+    // Used for tests, corresponds to
+    // brave/test/data/should-be-blocked-extension.
+    "mlklomjnahgiddgfdgjhibinlfibfffc",
+};
@@ -10,5 +10,6 @@
 #include <vector>
 
 extern const std::vector<std::string> kVettedExtensions;
+extern const std::vector<std::string> kBlacklistedExtensions;
 
 #endif  // BRAVE_COMMON_EXTENSIONS_WHITELIST_H_
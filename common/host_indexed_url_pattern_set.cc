@@ -0,0 +1,92 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/host_indexed_url_pattern_set.h"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+#include "base/strings/string_piece.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+HostIndexedURLPatternSet::HostIndexedURLPatternSet(
+    std::vector<URLPattern> patterns)
+    : patterns_(std::move(patterns)) {
+  std::unordered_map<std::string, std::vector<size_t>> host_index;
+  for (size_t i = 0; i < patterns_.size(); ++i) {
+    const std::string& host = patterns_[i].host();
+    if (host.empty())
+      any_host_.push_back(i);
+    else
+      host_index[host].push_back(i);
+  }
+  host_index_ = base::flat_map<std::string, std::vector<size_t>, std::less<>>(
+      std::make_move_iterator(host_index.begin()),
+      std::make_move_iterator(host_index.end()));
+}
+
+HostIndexedURLPatternSet::~HostIndexedURLPatternSet() = default;
+
+template <typename Visitor>
+void HostIndexedURLPatternSet::ForEachCandidateList(const GURL& url,
+                                                    Visitor visitor) const {
+  if (patterns_.empty() || !url.is_valid())
+    return;
+
+  if (!any_host_.empty())
+    visitor(any_host_);
+
+  // A pattern can only match if its host is the URL host or, for patterns
+  // matching subdomains, one of its dot-separated suffixes. URLPattern itself
+  // still makes the final decision for every candidate.
+  base::StringPiece host = url.host_piece();
+  while (!host.empty()) {
+    auto it = host_index_.find(host);
+    if (it != host_index_.end())
+      visitor(it->second);
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+}
+
+size_t HostIndexedURLPatternSet::FindFirstMatch(const GURL& url) const {
+  size_t first_match = kNoMatch;
+  ForEachCandidateList(url, [&](const std::vector<size_t>& candidates) {
+    for (size_t index : candidates) {
+      // Later candidates of the list can't come before the current match.
+      if (index >= first_match)
+        break;
+      if (patterns_[index].MatchesURL(url)) {
+        first_match = index;
+        break;
+      }
+    }
+  });
+  return first_match;
+}
+
+void HostIndexedURLPatternSet::GetMatches(const GURL& url,
+                                          std::vector<size_t>* matches) const {
+  const size_t old_size = matches->size();
+  ForEachCandidateList(url, [&](const std::vector<size_t>& candidates) {
+    for (size_t index : candidates) {
+      if (patterns_[index].MatchesURL(url))
+        matches->push_back(index);
+    }
+  });
+  std::sort(matches->begin() + old_size, matches->end());
+}
+
+bool HostIndexedURLPatternSet::MatchesURL(const GURL& url) const {
+  return FindFirstMatch(url) != kNoMatch;
+}
+
+}  // namespace brave
@@ -0,0 +1,64 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMMON_HOST_INDEXED_URL_PATTERN_SET_H_
+#define BRAVE_COMMON_HOST_INDEXED_URL_PATTERN_SET_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/macros.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace brave {
+
+// An immutable set of URLPatterns indexed by pattern host. A lookup walks the
+// dot-separated suffixes of the URL's host, so matching costs a handful of
+// index lookups plus a URLPattern test for each candidate sharing a host
+// suffix, rather than a test against every pattern in the set.
+class HostIndexedURLPatternSet {
+ public:
+  static constexpr size_t kNoMatch = static_cast<size_t>(-1);
+
+  explicit HostIndexedURLPatternSet(std::vector<URLPattern> patterns);
+  ~HostIndexedURLPatternSet();
+
+  bool MatchesURL(const GURL& url) const;
+
+  // Returns the index (in construction order) of the first pattern matching
+  // |url|, or |kNoMatch|.
+  size_t FindFirstMatch(const GURL& url) const;
+
+  // Appends the indices of all patterns matching |url| to |matches|, in
+  // construction order.
+  void GetMatches(const GURL& url, std::vector<size_t>* matches) const;
+
+  size_t size() const { return patterns_.size(); }
+
+ private:
+  // Calls |visitor| with each list of pattern indices which may match |url|.
+  // Every list is in construction order and no index is in two lists.
+  template <typename Visitor>
+  void ForEachCandidateList(const GURL& url, Visitor visitor) const;
+
+  std::vector<URLPattern> patterns_;
+  // Pattern host -> indices into |patterns_|. Transparent, so host suffixes
+  // can be looked up as string pieces without copying them.
+  base::flat_map<std::string, std::vector<size_t>, std::less<>> host_index_;
+  // Patterns with a wildcard host, checked for every URL.
+  std::vector<size_t> any_host_;
+
+  DISALLOW_COPY_AND_ASSIGN(HostIndexedURLPatternSet);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_HOST_INDEXED_URL_PATTERN_SET_H_
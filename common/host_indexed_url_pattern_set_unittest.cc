@@ -0,0 +1,101 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/common/host_indexed_url_pattern_set.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "brave/common/shield_exceptions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+using brave::HostIndexedURLPatternSet;
+
+std::vector<URLPattern> GetTestPatterns() {
+  return std::vector<URLPattern>({
+      URLPattern(URLPattern::SCHEME_ALL, "https://*.adobe.com/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "https://*.brave.com/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "https://pdfjs.robwu.nl/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "https://uphold.com/"),
+      URLPattern(URLPattern::SCHEME_HTTPS,
+                 "https://safebrowsing.google.com/safebrowsing/report*"),
+      URLPattern(URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS,
+                 "*://*.gvt1.com/*"),
+      URLPattern(URLPattern::SCHEME_ALL, "https://*/wildcard/*"),
+  });
+}
+
+std::vector<GURL> GetTestURLs() {
+  return std::vector<GURL>({
+      GURL("https://adobe.com/"),
+      GURL("https://www.adobe.com/foo"),
+      GURL("https://notadobe.com/"),
+      GURL("http://www.adobe.com/"),
+      GURL("https://a.b.c.brave.com/"),
+      GURL("https://brave.com.evil.com/"),
+      GURL("https://pdfjs.robwu.nl/viewer"),
+      GURL("https://sub.pdfjs.robwu.nl/viewer"),
+      GURL("https://uphold.com/"),
+      GURL("https://uphold.com/path"),
+      GURL("https://www.uphold.com/"),
+      GURL("https://safebrowsing.google.com/safebrowsing/report?x=1"),
+      GURL("https://safebrowsing.google.com/safebrowsing/other"),
+      GURL("http://redirector.gvt1.com/edgedl/"),
+      GURL("https://example.com/wildcard/path"),
+      GURL("https://example.com/other/path"),
+      GURL("https://127.0.0.1/"),
+      GURL("data:text/plain,hello"),
+      GURL(),
+  });
+}
+
+TEST(HostIndexedURLPatternSetTest, MatchesLinearScan) {
+  const std::vector<URLPattern> patterns = GetTestPatterns();
+  HostIndexedURLPatternSet pattern_set(patterns);
+  EXPECT_EQ(patterns.size(), pattern_set.size());
+
+  for (const GURL& url : GetTestURLs()) {
+    auto linear_match = std::find_if(
+        patterns.begin(), patterns.end(),
+        [&url](const URLPattern& pattern) { return pattern.MatchesURL(url); });
+    const size_t expected_index =
+        linear_match == patterns.end()
+            ? HostIndexedURLPatternSet::kNoMatch
+            : static_cast<size_t>(linear_match - patterns.begin());
+    EXPECT_EQ(expected_index, pattern_set.FindFirstMatch(url))
+        << url.possibly_invalid_spec();
+    EXPECT_EQ(linear_match != patterns.end(), pattern_set.MatchesURL(url))
+        << url.possibly_invalid_spec();
+  }
+}
+
+TEST(HostIndexedURLPatternSetTest, EmptySet) {
+  HostIndexedURLPatternSet pattern_set((std::vector<URLPattern>()));
+  EXPECT_FALSE(pattern_set.MatchesURL(GURL("https://brave.com/")));
+}
+
+TEST(HostIndexedURLPatternSetTest, ShieldExceptions) {
+  EXPECT_TRUE(brave::IsUAWhitelisted(GURL("https://www.netflix.com/title")));
+  EXPECT_TRUE(brave::IsUAWhitelisted(GURL("https://duckduckgo.com/")));
+  EXPECT_FALSE(brave::IsUAWhitelisted(GURL("http://www.netflix.com/")));
+  EXPECT_FALSE(brave::IsUAWhitelisted(GURL("https://netflix.com.evil.com/")));
+
+  EXPECT_TRUE(brave::IsBlockedResource(GURL("https://pdfjs.robwu.nl/x")));
+  EXPECT_FALSE(brave::IsBlockedResource(GURL("https://robwu.nl/x")));
+
+  EXPECT_TRUE(brave::IsWhitelistedFingerprintingException(
+      GURL("https://brave.com/"), GURL("https://public.tableau.com/views")));
+  EXPECT_TRUE(brave::IsWhitelistedFingerprintingException(
+      GURL("https://brave.com/"), GURL("https://www.arcgis.com/")));
+  EXPECT_TRUE(brave::IsWhitelistedFingerprintingException(
+      GURL("https://uphold.com/"), GURL("https://id.veriff.me/")));
+  EXPECT_FALSE(brave::IsWhitelistedFingerprintingException(
+      GURL("https://brave.com/"), GURL("https://id.veriff.me/")));
+}
+
+}  // namespace
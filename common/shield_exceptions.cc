@@ -5,83 +5,120 @@
 
 #include "brave/common/shield_exceptions.h"
 
-#include <algorithm>
-#include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "brave/common/host_indexed_url_pattern_set.h"
 #include "extensions/common/url_pattern.h"
 #include "url/gurl.h"
 
 namespace brave {
 
+namespace {
+
+struct FingerprintingException {
+  URLPattern first_party;
+  std::vector<URLPattern> subresources;
+};
+
+// Index of first-party patterns plus, at the same positions, the subresource
+// patterns allowed under each of them.
+class FingerprintingExceptions {
+ public:
+  explicit FingerprintingExceptions(
+      std::vector<FingerprintingException> exceptions)
+      : first_party_patterns_(GetFirstPartyPatterns(exceptions)) {
+    for (auto& exception : exceptions) {
+      subresource_patterns_.push_back(
+          std::make_unique<HostIndexedURLPatternSet>(
+              std::move(exception.subresources)));
+    }
+  }
+
+  bool IsWhitelisted(const GURL& first_party_origin,
+                     const GURL& subresource_url) const {
+    size_t index = first_party_patterns_.FindFirstMatch(first_party_origin);
+    if (index == HostIndexedURLPatternSet::kNoMatch)
+      return false;
+    return subresource_patterns_[index]->MatchesURL(subresource_url);
+  }
+
+ private:
+  static std::vector<URLPattern> GetFirstPartyPatterns(
+      const std::vector<FingerprintingException>& exceptions) {
+    std::vector<URLPattern> patterns;
+    for (const auto& exception : exceptions)
+      patterns.push_back(exception.first_party);
+    return patterns;
+  }
+
+  HostIndexedURLPatternSet first_party_patterns_;
+  std::vector<std::unique_ptr<HostIndexedURLPatternSet>> subresource_patterns_;
+
+  DISALLOW_COPY_AND_ASSIGN(FingerprintingExceptions);
+};
+
+}  // namespace
+
 bool IsUAWhitelisted(const GURL& gurl) {
-  static std::vector<URLPattern> whitelist_patterns({
-    URLPattern(URLPattern::SCHEME_ALL, "https://*.adobe.com/*"),
-    URLPattern(URLPattern::SCHEME_ALL, "https://*.duckduckgo.com/*"),
-    URLPattern(URLPattern::SCHEME_ALL, "https://*.brave.com/*"),
-    // For Widevine
-    URLPattern(URLPattern::SCHEME_ALL, "https://*.netflix.com/*")
-  });
-  return std::any_of(whitelist_patterns.begin(), whitelist_patterns.end(),
-      [&gurl](URLPattern pattern){
-        return pattern.MatchesURL(gurl);
-      });
+  static const base::NoDestructor<HostIndexedURLPatternSet> whitelist_patterns(
+      std::vector<URLPattern>({
+        URLPattern(URLPattern::SCHEME_ALL, "https://*.adobe.com/*"),
+        URLPattern(URLPattern::SCHEME_ALL, "https://*.duckduckgo.com/*"),
+        URLPattern(URLPattern::SCHEME_ALL, "https://*.brave.com/*"),
+        // For Widevine
+        URLPattern(URLPattern::SCHEME_ALL, "https://*.netflix.com/*")
+      }));
+  return whitelist_patterns->MatchesURL(gurl);
 }
 
 bool IsBlockedResource(const GURL& gurl) {
-  static std::vector<URLPattern> blocked_patterns({
-      URLPattern(URLPattern::SCHEME_ALL, "https://pdfjs.robwu.nl/*")
-  });
-  return std::any_of(blocked_patterns.begin(), blocked_patterns.end(),
-                     [&gurl](URLPattern pattern){
-                       return pattern.MatchesURL(gurl);
-                     });
+  static const base::NoDestructor<HostIndexedURLPatternSet> blocked_patterns(
+      std::vector<URLPattern>({
+        URLPattern(URLPattern::SCHEME_ALL, "https://pdfjs.robwu.nl/*")
+      }));
+  return blocked_patterns->MatchesURL(gurl);
 }
 
 bool IsWhitelistedFingerprintingException(const GURL& firstPartyOrigin,
     const GURL& subresourceUrl) {
   // Always allow embeds from public.tableau.com while fingerprinting
   // protections are being reworked to need less exceptions.
-  static const std::vector<URLPattern> embed_exceptions = {
-    URLPattern(URLPattern::SCHEME_ALL, "https://public.tableau.com/*"),
-    URLPattern(URLPattern::SCHEME_ALL, "https://www.arcgis.com/*"),
-  };
-  for (const auto exception : embed_exceptions) {
-    if (exception.MatchesURL(subresourceUrl)) {
-      return true;
-    }
-  }
-
-  static std::map<URLPattern, std::vector<URLPattern> > whitelist_patterns = {
-    {
-      URLPattern(URLPattern::SCHEME_ALL, "https://uphold.com/"),
-      std::vector<URLPattern>({
-        URLPattern(URLPattern::SCHEME_ALL, "https://uphold.netverify.com/*"),
-        URLPattern(URLPattern::SCHEME_ALL, "https://*.veriff.me/*"),
-      })
-    },
-    {
-      URLPattern(URLPattern::SCHEME_ALL, "https://sandbox.uphold.com/"),
+  static const base::NoDestructor<HostIndexedURLPatternSet> embed_exceptions(
       std::vector<URLPattern>({
-        URLPattern(URLPattern::SCHEME_ALL, "https://*.netverify.com/*"),
-        URLPattern(URLPattern::SCHEME_ALL, "https://*.veriff.me/*"),
-      })
-    },
-    {
-      URLPattern(URLPattern::SCHEME_ALL, "https://*.1password.com/*"),
-      std::vector<URLPattern>({URLPattern(URLPattern::SCHEME_ALL,
-            "https://map.1passwordservices.com/*")})
-    }
-  };
-  for (const auto whitelist : whitelist_patterns) {
-      if (whitelist.first.MatchesURL(firstPartyOrigin)) {
-          return std::any_of(whitelist.second.begin(), whitelist.second.end(),
-            [&subresourceUrl](const URLPattern& pattern) {
-              return pattern.MatchesURL(subresourceUrl);
-          });
-      }
-  }
-  return false;
+        URLPattern(URLPattern::SCHEME_ALL, "https://public.tableau.com/*"),
+        URLPattern(URLPattern::SCHEME_ALL, "https://www.arcgis.com/*"),
+      }));
+  if (embed_exceptions->MatchesURL(subresourceUrl))
+    return true;
+
+  static const base::NoDestructor<FingerprintingExceptions> whitelist_patterns(
+      std::vector<FingerprintingException>({
+        {
+          URLPattern(URLPattern::SCHEME_ALL, "https://*.1password.com/*"),
+          std::vector<URLPattern>({URLPattern(URLPattern::SCHEME_ALL,
+                "https://map.1passwordservices.com/*")})
+        },
+        {
+          URLPattern(URLPattern::SCHEME_ALL, "https://sandbox.uphold.com/"),
+          std::vector<URLPattern>({
+            URLPattern(URLPattern::SCHEME_ALL, "https://*.netverify.com/*"),
+            URLPattern(URLPattern::SCHEME_ALL, "https://*.veriff.me/*"),
+          })
+        },
+        {
+          URLPattern(URLPattern::SCHEME_ALL, "https://uphold.com/"),
+          std::vector<URLPattern>({
+            URLPattern(URLPattern::SCHEME_ALL,
+                       "https://uphold.netverify.com/*"),
+            URLPattern(URLPattern::SCHEME_ALL, "https://*.veriff.me/*"),
+          })
+        },
+      }));
+  return whitelist_patterns->IsWhitelisted(firstPartyOrigin, subresourceUrl);
 }
 
 }  // namespace brave
@@ -44,4 +44,15 @@ std::string GetDATFileAsString(const base::FilePath& file_path) {
   return contents;
 }
 
+bool MapDATFile(const base::FilePath& file_path,
+                base::MemoryMappedFile* mapped_file) {
+  if (!mapped_file->Initialize(file_path) || 0 == mapped_file->length()) {
+    LOG(ERROR) << "MapDATFile: "
+               << "the dat file is not found or corrupted "
+               << file_path;
+    return false;
+  }
+  return true;
+}
+
 }  // namespace brave_component_updater
@@ -12,6 +12,8 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
 
 namespace brave_component_updater {
 
@@ -20,6 +22,8 @@ using DATFileDataBuffer = std::vector<unsigned char>;
 void GetDATFileData(const base::FilePath& file_path,
                     DATFileDataBuffer* buffer);
 std::string GetDATFileAsString(const base::FilePath& file_path);
+bool MapDATFile(const base::FilePath& file_path,
+                base::MemoryMappedFile* mapped_file);
 
 template<typename T>
 using LoadDATFileDataResult =
@@ -41,6 +45,27 @@ LoadDATFileDataResult<T> LoadDATFileData(
       std::move(client), std::move(buffer));
 }
 
+// Deserializes straight from a read-only mapping of the dat file instead of
+// a heap copy, for clients that don't reference the serialized data after
+// deserialize() returns. The mapping is released before returning. Returns
+// nullptr if the file can't be mapped or deserialized.
+template<typename T>
+std::unique_ptr<T> LoadMappedDATFileData(
+    const base::FilePath& dat_file_path) {
+  base::MemoryMappedFile mapped_file;
+  if (!MapDATFile(dat_file_path, &mapped_file))
+    return nullptr;
+
+  auto client = std::make_unique<T>();
+  if (!client->deserialize(reinterpret_cast<const char*>(mapped_file.data()),
+                           mapped_file.length())) {
+    LOG(ERROR) << "LoadMappedDATFileData: cannot "
+               << "deserialize dat file " << dat_file_path;
+    return nullptr;
+  }
+  return client;
+}
+
 
 }  // namespace brave_component_updater
 
@@ -0,0 +1,63 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_component_updater/browser/dat_file_util.h"
+
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Copies what it needs out of the serialized data, like adblock::Engine.
+class TestDATClient {
+ public:
+  bool deserialize(const char* data, size_t size) {
+    contents_.assign(data, size);
+    return contents_ != "corrupted";
+  }
+
+  const std::string& contents() const { return contents_; }
+
+ private:
+  std::string contents_;
+};
+
+class DATFileUtilTest : public testing::Test {
+ public:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  base::FilePath WriteDATFile(const std::string& contents) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII("test.dat");
+    EXPECT_EQ(static_cast<int>(contents.size()),
+              base::WriteFile(path, contents.data(), contents.size()));
+    return path;
+  }
+
+ private:
+  base::ScopedTempDir temp_dir_;
+};
+
+}  // namespace
+
+TEST_F(DATFileUtilTest, LoadMappedDATFileData) {
+  const std::string contents(1024 * 1024, 'x');
+  auto client =
+      brave_component_updater::LoadMappedDATFileData<TestDATClient>(
+          WriteDATFile(contents));
+  ASSERT_TRUE(client);
+  EXPECT_EQ(contents, client->contents());
+}
+
+TEST_F(DATFileUtilTest, LoadMappedDATFileDataFailures) {
+  EXPECT_FALSE(brave_component_updater::LoadMappedDATFileData<TestDATClient>(
+      base::FilePath(FILE_PATH_LITERAL("does_not_exist.dat"))));
+  EXPECT_FALSE(brave_component_updater::LoadMappedDATFileData<TestDATClient>(
+      WriteDATFile(std::string())));
+  EXPECT_FALSE(brave_component_updater::LoadMappedDATFileData<TestDATClient>(
+      WriteDATFile("corrupted")));
+}
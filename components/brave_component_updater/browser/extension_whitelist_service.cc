@@ -8,7 +8,6 @@
 #include <utility>
 
 #include "base/bind.h"
-#include "base/task_runner_util.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
 #include "brave/vendor/extension-whitelist/extension_whitelist_parser.h"
 #include "extensions/common/extension.h"
@@ -19,10 +18,12 @@ namespace brave_component_updater {
 
 ExtensionWhitelistService::ExtensionWhitelistService(
     LocalDataFilesService* local_data_files_service,
-    const std::vector<std::string>& whitelist)
+    const std::vector<std::string>& whitelist,
+    const std::vector<std::string>& blacklist)
     : LocalDataFilesObserver(local_data_files_service),
       extension_whitelist_client_(new ExtensionWhitelistParser()),
-      whitelist_(whitelist),
+      whitelist_(whitelist.begin(), whitelist.end()),
+      blacklist_(blacklist.begin(), blacklist.end()),
       weak_factory_(this) {
 }
 
@@ -40,6 +41,9 @@ bool ExtensionWhitelistService::IsWhitelisted(
 bool ExtensionWhitelistService::IsBlacklisted(
     const std::string& extension_id) const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (blacklist_.contains(extension_id))
+    return true;
+
   return extension_whitelist_client_->isBlacklisted(extension_id.c_str());
 }
 
@@ -48,8 +52,7 @@ bool ExtensionWhitelistService::IsVetted(const Extension* extension) const {
 }
 
 bool ExtensionWhitelistService::IsVetted(const std::string& id) const {
-  if (std::find(whitelist_.begin(), whitelist_.end(), id) !=
-      whitelist_.end())
+  if (whitelist_.contains(id))
     return true;
 
   return IsWhitelisted(id);
@@ -64,9 +67,8 @@ void ExtensionWhitelistService::OnComponentReady(
       .AppendASCII(EXTENSION_DAT_FILE_VERSION)
       .AppendASCII(EXTENSION_DAT_FILE);
 
-  base::PostTaskAndReplyWithResult(
-      local_data_files_service()->GetTaskRunner().get(),
-      FROM_HERE,
+  LoadData(
+      "ExtensionWhitelist",
       base::BindOnce(
           &brave_component_updater::LoadDATFileData<ExtensionWhitelistParser>,
           dat_file_path),
@@ -93,9 +95,10 @@ void ExtensionWhitelistService::OnGetDATFileData(GetDATFileDataResult result) {
 
 std::unique_ptr<ExtensionWhitelistService> ExtensionWhitelistServiceFactory(
     LocalDataFilesService* local_data_files_service,
-    const std::vector<std::string>& whitelist) {
+    const std::vector<std::string>& whitelist,
+    const std::vector<std::string>& blacklist) {
   return std::make_unique<ExtensionWhitelistService>(local_data_files_service,
-                                                     whitelist);
+                                                     whitelist, blacklist);
 }
 
 }  // namespace brave_component_updater
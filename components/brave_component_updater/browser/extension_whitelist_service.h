@@ -12,6 +12,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/containers/flat_set.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
@@ -36,7 +37,8 @@ class ExtensionWhitelistService : public LocalDataFilesObserver {
 
   explicit ExtensionWhitelistService(
       LocalDataFilesService* local_data_files_service,
-      const std::vector<std::string>& whitelist);
+      const std::vector<std::string>& whitelist,
+      const std::vector<std::string>& blacklist);
   ~ExtensionWhitelistService() override;
 
   bool IsWhitelisted(const std::string& extension_id) const;
@@ -58,7 +60,10 @@ class ExtensionWhitelistService : public LocalDataFilesObserver {
   SEQUENCE_CHECKER(sequence_checker_);
   std::unique_ptr<ExtensionWhitelistParser> extension_whitelist_client_;
   brave_component_updater::DATFileDataBuffer buffer_;
-  std::vector<std::string> whitelist_;
+  // Hardcoded ids that are always vetted or always blocked, on top of
+  // whatever the component data says.
+  const base::flat_set<std::string> whitelist_;
+  const base::flat_set<std::string> blacklist_;
   base::WeakPtrFactory<ExtensionWhitelistService> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(ExtensionWhitelistService);
@@ -67,7 +72,8 @@ class ExtensionWhitelistService : public LocalDataFilesObserver {
 // Creates the ExtensionWhitelistService
 std::unique_ptr<ExtensionWhitelistService> ExtensionWhitelistServiceFactory(
     LocalDataFilesService* local_data_files_service,
-    const std::vector<std::string>& whitelist);
+    const std::vector<std::string>& whitelist,
+    const std::vector<std::string>& blacklist);
 
 }  // namespace brave_component_updater
 
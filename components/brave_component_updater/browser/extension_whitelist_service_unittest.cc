@@ -0,0 +1,48 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_component_updater/browser/extension_whitelist_service.h"
+
+#include <string>
+
+#include "base/test/task_environment.h"
+#include "brave/components/brave_component_updater/browser/local_data_files_service.h"
+#include "brave/components/brave_component_updater/browser/test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_component_updater::ExtensionWhitelistService;
+using brave_component_updater::LocalDataFilesService;
+using brave_component_updater::TestComponentDelegate;
+
+namespace {
+
+const char kVettedId[] = "aapnijgdinlhnhlmodcfapnahmbfebeb";
+const char kBlockedId[] = "mlklomjnahgiddgfdgjhibinlfibfffc";
+const char kOtherId[] = "kpbdcmcgkedhpbcpfndimofjnefgjidd";
+
+}  // namespace
+
+class ExtensionWhitelistServiceTest : public testing::Test {
+ public:
+  ExtensionWhitelistServiceTest()
+      : local_data_files_service_(&delegate_),
+        service_(&local_data_files_service_, {kVettedId}, {kBlockedId}) {}
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  TestComponentDelegate delegate_;
+  LocalDataFilesService local_data_files_service_;
+  ExtensionWhitelistService service_;
+};
+
+TEST_F(ExtensionWhitelistServiceTest, HardcodedLists) {
+  EXPECT_TRUE(service_.IsVetted(kVettedId));
+  EXPECT_FALSE(service_.IsVetted(kBlockedId));
+  EXPECT_FALSE(service_.IsVetted(kOtherId));
+
+  EXPECT_TRUE(service_.IsBlacklisted(kBlockedId));
+  EXPECT_FALSE(service_.IsBlacklisted(kVettedId));
+  EXPECT_FALSE(service_.IsBlacklisted(kOtherId));
+}
@@ -5,14 +5,19 @@
 
 #include "brave/components/brave_component_updater/browser/local_data_files_observer.h"
 
+#include "base/task/post_task.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
 
 namespace brave_component_updater {
 
 LocalDataFilesObserver::LocalDataFilesObserver(
-    LocalDataFilesService* local_data_files_service)
+    LocalDataFilesService* local_data_files_service,
+    base::TaskPriority priority)
     : local_data_files_service_(local_data_files_service),
-      local_data_files_observer_(this) {
+      local_data_files_observer_(this),
+      task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::MayBlock(), priority,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {
   local_data_files_observer_.Add(local_data_files_service);
 }
 
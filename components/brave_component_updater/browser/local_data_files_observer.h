@@ -7,9 +7,16 @@
 #define BRAVE_COMPONENTS_BRAVE_COMPONENT_UPDATER_BROWSER_LOCAL_DATA_FILES_OBSERVER_H_
 
 #include <string>
+#include <utility>
 
+#include "base/bind.h"
 #include "base/files/file_path.h"
+#include "base/memory/weak_ptr.h"
 #include "base/scoped_observer.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task/task_traits.h"
+#include "base/task_runner_util.h"
+#include "base/trace_event/trace_event.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
 
 namespace brave_component_updater {
@@ -19,8 +26,11 @@ namespace brave_component_updater {
 // like tracking protection.
 class LocalDataFilesObserver {
  public:
+  // Observers whose data is consulted on the network request path should use
+  // base::TaskPriority::USER_BLOCKING so their files load first.
   explicit LocalDataFilesObserver(
-      LocalDataFilesService* local_data_files_service);
+      LocalDataFilesService* local_data_files_service,
+      base::TaskPriority priority = base::TaskPriority::USER_VISIBLE);
   virtual ~LocalDataFilesObserver();
   virtual void OnComponentReady(const std::string& component_id,
                                 const base::FilePath& install_dir,
@@ -29,9 +39,46 @@ class LocalDataFilesObserver {
   LocalDataFilesService* local_data_files_service();
 
  protected:
+  // Runs |load| on this observer's own pool sequence, so that observers
+  // load in parallel, and |reply| with its result on the calling sequence.
+  // The load is traced under |name| and counted towards the service's
+  // readiness barrier until |reply| has run.
+  template <typename T>
+  void LoadData(const char* name,
+                base::OnceCallback<T()> load,
+                base::OnceCallback<void(T)> reply) {
+    if (!local_data_files_service_)
+      return;
+    local_data_files_service_->OnLoadStarted();
+    TRACE_EVENT_NESTABLE_ASYNC_BEGIN1("browser,startup",
+                                      "LocalDataFilesObserver::LoadData",
+                                      TRACE_ID_LOCAL(this), "name", name);
+    base::PostTaskAndReplyWithResult(
+        task_runner_.get(), FROM_HERE, std::move(load),
+        base::BindOnce(&LocalDataFilesObserver::OnDataLoaded<T>,
+                       local_data_files_service_->GetWeakPtr(),
+                       static_cast<const void*>(this), std::move(reply)));
+  }
+
   LocalDataFilesService* local_data_files_service_;  // NOT OWNED
   ScopedObserver<LocalDataFilesService, LocalDataFilesObserver>
       local_data_files_observer_;
+
+ private:
+  template <typename T>
+  static void OnDataLoaded(base::WeakPtr<LocalDataFilesService> service,
+                           const void* trace_id,
+                           base::OnceCallback<void(T)> reply,
+                           T result) {
+    std::move(reply).Run(std::move(result));
+    TRACE_EVENT_NESTABLE_ASYNC_END0("browser,startup",
+                                    "LocalDataFilesObserver::LoadData",
+                                    TRACE_ID_LOCAL(trace_id));
+    if (service)
+      service->OnLoadFinished();
+  }
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
 };
 
 }  // namespace brave_component_updater
@@ -5,6 +5,9 @@
 
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
 
+#include <utility>
+
+#include "base/trace_event/trace_event.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_observer.h"
 
 using brave_component_updater::BraveComponent;
@@ -40,10 +43,42 @@ void LocalDataFilesService::OnComponentReady(
     const std::string& component_id,
     const base::FilePath& install_dir,
     const std::string& manifest) {
+  TRACE_EVENT0("browser,startup", "LocalDataFilesService::OnComponentReady");
+  // Observers only start their loads here; the loads themselves run in
+  // parallel on the thread pool.
   for (auto& observer : observers_)
     observer.OnComponentReady(component_id, install_dir, manifest);
 }
 
+void LocalDataFilesService::RunWhenReady(base::OnceClosure callback) {
+  if (pending_loads_ == 0) {
+    std::move(callback).Run();
+    return;
+  }
+  ready_callbacks_.push_back(std::move(callback));
+}
+
+void LocalDataFilesService::OnLoadStarted() {
+  ++pending_loads_;
+}
+
+void LocalDataFilesService::OnLoadFinished() {
+  DCHECK_GT(pending_loads_, 0);
+  if (--pending_loads_ > 0)
+    return;
+
+  TRACE_EVENT_INSTANT0("browser,startup", "LocalDataFilesService::Ready",
+                       TRACE_EVENT_SCOPE_THREAD);
+  std::vector<base::OnceClosure> callbacks;
+  callbacks.swap(ready_callbacks_);
+  for (auto& callback : callbacks)
+    std::move(callback).Run();
+}
+
+base::WeakPtr<LocalDataFilesService> LocalDataFilesService::GetWeakPtr() {
+  return weak_factory_.GetWeakPtr();
+}
+
 void LocalDataFilesService::AddObserver(LocalDataFilesObserver* observer) {
   observers_.AddObserver(observer);
 }
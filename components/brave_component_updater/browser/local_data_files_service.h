@@ -8,8 +8,11 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "base/callback.h"
 #include "base/files/file_path.h"
+#include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "brave/components/brave_component_updater/browser/brave_component.h"
 
@@ -39,6 +42,10 @@ class LocalDataFilesService : public BraveComponent {
   void AddObserver(LocalDataFilesObserver* observer);
   void RemoveObserver(LocalDataFilesObserver* observer);
 
+  // Readiness barrier: runs |callback| once no observer has a load in
+  // flight, or right away if none has.
+  void RunWhenReady(base::OnceClosure callback);
+
   static void SetComponentIdAndBase64PublicKeyForTest(
       const std::string& component_id,
       const std::string& component_base64_public_key);
@@ -49,11 +56,20 @@ class LocalDataFilesService : public BraveComponent {
       const std::string& manifest) override;
 
  private:
+  friend class LocalDataFilesObserver;
+
+  void OnLoadStarted();
+  void OnLoadFinished();
+  base::WeakPtr<LocalDataFilesService> GetWeakPtr();
+
   static std::string g_local_data_files_component_id_;
   static std::string g_local_data_files_component_base64_public_key_;
 
   bool initialized_;
   base::ObserverList<LocalDataFilesObserver>::Unchecked observers_;
+  int pending_loads_ = 0;
+  std::vector<base::OnceClosure> ready_callbacks_;
+  base::WeakPtrFactory<LocalDataFilesService> weak_factory_{this};
 
   DISALLOW_COPY_AND_ASSIGN(LocalDataFilesService);
 };
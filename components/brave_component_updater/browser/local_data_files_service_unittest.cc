@@ -0,0 +1,85 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_component_updater/browser/local_data_files_service.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "brave/components/brave_component_updater/browser/local_data_files_observer.h"
+#include "brave/components/brave_component_updater/browser/test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_component_updater::LocalDataFilesObserver;
+using brave_component_updater::LocalDataFilesService;
+using brave_component_updater::TestComponentDelegate;
+
+namespace {
+
+class TestObserver : public LocalDataFilesObserver {
+ public:
+  TestObserver(LocalDataFilesService* local_data_files_service,
+               base::TaskPriority priority)
+      : LocalDataFilesObserver(local_data_files_service, priority) {}
+
+  void OnComponentReady(const std::string& component_id,
+                        const base::FilePath& install_dir,
+                        const std::string& manifest) override {
+    LoadData("Test",
+             base::BindOnce(
+                 [](base::FilePath install_dir) {
+                   return install_dir.BaseName().AsUTF8Unsafe();
+                 },
+                 install_dir),
+             base::BindOnce(&TestObserver::OnDataLoaded,
+                            weak_factory_.GetWeakPtr()));
+  }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  void OnDataLoaded(std::string data) { data_ = data; }
+
+  std::string data_;
+  base::WeakPtrFactory<TestObserver> weak_factory_{this};
+};
+
+}  // namespace
+
+TEST(LocalDataFilesServiceTest, RunWhenReadyWaitsForAllObservers) {
+  base::test::TaskEnvironment task_environment;
+  TestComponentDelegate delegate;
+  LocalDataFilesService service(&delegate);
+  TestObserver request_path_observer(&service,
+                                     base::TaskPriority::USER_BLOCKING);
+  TestObserver other_observer(&service, base::TaskPriority::USER_VISIBLE);
+
+  bool ready = false;
+  service.RunWhenReady(base::BindOnce([](bool* ready) { *ready = true; },
+                                      &ready));
+  // Nothing is loading yet.
+  EXPECT_TRUE(ready);
+
+  const base::FilePath install_dir(FILE_PATH_LITERAL("1.0.0"));
+  request_path_observer.OnComponentReady("id", install_dir, "");
+  other_observer.OnComponentReady("id", install_dir, "");
+
+  ready = false;
+  base::RunLoop run_loop;
+  service.RunWhenReady(base::BindOnce(
+      [](bool* ready, base::OnceClosure quit) {
+        *ready = true;
+        std::move(quit).Run();
+      },
+      &ready, run_loop.QuitClosure()));
+  EXPECT_FALSE(ready);
+  run_loop.Run();
+
+  EXPECT_TRUE(ready);
+  EXPECT_EQ("1.0.0", request_path_observer.data());
+  EXPECT_EQ("1.0.0", other_observer.data());
+}
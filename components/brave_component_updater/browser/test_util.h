@@ -0,0 +1,39 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_COMPONENT_UPDATER_BROWSER_TEST_UTIL_H_
+#define BRAVE_COMPONENTS_BRAVE_COMPONENT_UPDATER_BROWSER_TEST_UTIL_H_
+
+#include <string>
+
+#include "base/macros.h"
+#include "brave/components/brave_component_updater/browser/brave_component.h"
+
+namespace brave_component_updater {
+
+// Never installs anything and runs component tasks on the current sequence,
+// so services built on LocalDataFilesService can be tested without the
+// component updater.
+class TestComponentDelegate : public BraveComponent::Delegate {
+ public:
+  TestComponentDelegate();
+  ~TestComponentDelegate() override;
+
+  // BraveComponent::Delegate implementation
+  void Register(const std::string& component_name,
+                const std::string& component_base64_public_key,
+                base::OnceClosure registered_callback,
+                BraveComponent::ReadyCallback ready_callback) override;
+  bool Unregister(const std::string& component_id) override;
+  void OnDemandUpdate(const std::string& component_id) override;
+  scoped_refptr<base::SequencedTaskRunner> GetTaskRunner() override;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TestComponentDelegate);
+};
+
+}  // namespace brave_component_updater
+
+#endif  // BRAVE_COMPONENTS_BRAVE_COMPONENT_UPDATER_BROWSER_TEST_UTIL_H_
@@ -9,6 +9,9 @@ if (chrome.braveShields) {
   chrome.braveShields.onBlocked.addListener((detail: BlockDetails) => {
     actions.resourceBlocked(detail)
   })
+  chrome.braveShields.onBlockedBatch.addListener((details: BlockDetails[]) => {
+    actions.resourcesBlocked(details)
+  })
 } else {
   console.log('chrome.braveShields not enabled')
 }
@@ -196,6 +196,19 @@ export default function shieldsPanelReducer (
       }
       break
     }
+    case shieldsPanelTypes.RESOURCES_BLOCKED: {
+      const currentTabId: number = shieldsPanelState.getActiveTabId(state)
+      state = shieldsPanelState.updateResourcesBlocked(state, action.details)
+      const isCurrentTabBlocked: boolean =
+        action.details.some((detail) => detail.tabId === currentTabId)
+      if (isCurrentTabBlocked) {
+        const isShieldsActive: boolean = shieldsPanelState.isShieldsActive(state, currentTabId)
+        if (isShieldsActive) {
+          shieldsPanelState.updateShieldsIconBadgeText(state)
+        }
+      }
+      break
+    }
     case shieldsPanelTypes.BLOCK_ADS_TRACKERS: {
       const tabId: number = shieldsPanelState.getActiveTabId(state)
       const tabData = shieldsPanelState.getActiveTabData(state)
@@ -116,6 +116,11 @@ export const updateResourceBlocked: shieldState.UpdateResourceBlocked = (state,
   return { ...state, tabs }
 }
 
+export const updateResourcesBlocked: shieldState.UpdateResourcesBlocked = (state, details) => {
+  return details.reduce((nextState, detail) =>
+    updateResourceBlocked(nextState, detail.tabId, detail.blockType, detail.subresource), state)
+}
+
 export const saveCosmeticFilterRuleExceptions: shieldState.SaveCosmeticFilterRuleExceptions = (state, tabId, exceptions) => {
   const tabs: shieldState.Tabs = { ...state.tabs }
   tabs[tabId] = { ...tabs[tabId], ...{ cosmeticFilters: { ...tabs[tabId].cosmeticFilters, ruleExceptions: exceptions } } }
@@ -59,6 +59,15 @@ export interface ResourceBlocked {
   (details: BlockDetails): ResourceBlockedReturn
 }
 
+interface ResourcesBlockedReturn {
+  type: types.RESOURCES_BLOCKED
+  details: BlockDetails[]
+}
+
+export interface ResourcesBlocked {
+  (details: BlockDetails[]): ResourcesBlockedReturn
+}
+
 interface BlockAdsTrackersReturn {
   type: types.BLOCK_ADS_TRACKERS
   setting: BlockOptions
@@ -210,6 +219,7 @@ export type shieldPanelActions =
   ShieldsToggledReturn |
   ReportBrokenSiteReturn |
   ResourceBlockedReturn |
+  ResourcesBlockedReturn |
   BlockAdsTrackersReturn |
   ControlsToggledReturn |
   HttpsEverywhereToggledReturn |
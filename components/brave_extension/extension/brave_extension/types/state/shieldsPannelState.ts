@@ -6,6 +6,7 @@ import { BlockOptions, BlockTypes, BlockFPOptions, BlockCookiesOptions } from '.
 import { CosmeticFilteringState } from '../adblock/adblockTypes'
 import { NoScriptInfo } from '../other/noScriptInfo'
 import { SettingsData } from '../other/settingsTypes'
+import { BlockDetails } from '../actions/shieldsPanelActions'
 
 export interface Tab {
   cosmeticBlocking: boolean
@@ -94,6 +95,10 @@ export interface UpdateResourceBlocked {
   (state: State, tabId: number, blockType: BlockTypes, subresource: string): State
 }
 
+export interface UpdateResourcesBlocked {
+  (state: State, details: BlockDetails[]): State
+}
+
 export interface SaveCosmeticFilterRuleExceptions {
   (state: State, tabId: number, exceptions: Array<string>): State
 }
@@ -11,6 +11,7 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "base/no_destructor.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 
 namespace brave_perf_predictor {
@@ -37,7 +38,7 @@ bool StandardiseFeatsNoOutliers(
 
 }  // namespace
 
-double LinregPredictVector(const std::array<double, feature_count>& features) {
+double LinregPredictVector(const FeatureVector& features) {
   // Standardise numeric features
   std::array<double, standardise_feat_count> numeric_features;
   std::copy(features.begin(), features.begin() + standardise_feat_count,
@@ -50,7 +51,7 @@ double LinregPredictVector(const std::array<double, feature_count>& features) {
   }
 
   // Create a new feature vector to include all features
-  std::array<double, feature_count> standardised_features;
+  FeatureVector standardised_features;
   std::move(numeric_features.begin(), numeric_features.end(),
             standardised_features.begin());
   // Just copy the rest of the features as-is
@@ -66,7 +67,7 @@ double LinregPredictVector(const std::array<double, feature_count>& features) {
 }
 
 double LinregPredictNamed(const base::flat_map<std::string, double>& features) {
-  std::array<double, feature_count> feature_vector{};
+  FeatureVector feature_vector{};
   for (unsigned int i = 0; i < feature_count; i++) {
     auto it = features.find(feature_sequence.at(i));
     if (it != features.end())
@@ -75,4 +76,20 @@ double LinregPredictNamed(const base::flat_map<std::string, double>& features) {
   return LinregPredictVector(feature_vector);
 }
 
+base::Optional<size_t> ThirdPartyBlockedFeatureSlot(base::StringPiece entity) {
+  static const base::NoDestructor<base::flat_map<base::StringPiece, size_t>>
+      slots([] {
+        std::vector<std::pair<base::StringPiece, size_t>> entries;
+        entries.reserve(relevant_entities.size());
+        for (size_t i = 0; i < relevant_entities.size(); ++i)
+          entries.emplace_back(relevant_entities[i],
+                               kFirstThirdPartyBlocked + i);
+        return base::flat_map<base::StringPiece, size_t>(std::move(entries));
+      }());
+  const auto it = slots->find(entity);
+  if (it == slots->end())
+    return base::nullopt;
+  return it->second;
+}
+
 }  // namespace brave_perf_predictor
@@ -6,14 +6,60 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_H_
 #define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_H_
 
+#include <stddef.h>
+
+#include <array>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/optional.h"
+#include "base/strings/string_piece.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 
 namespace brave_perf_predictor {
 
+using FeatureVector = std::array<double, feature_count>;
+
+// Slots in |feature_sequence| of the features accumulated by the predictor.
+// They are followed by one "thirdParties.<entity>.blocked" feature per entry
+// in |relevant_entities|, starting at |kFirstThirdPartyBlocked|.
+enum FeatureSlot : size_t {
+  kAdblockRequests = 0,
+  kFirstMeaningfulPaint,
+  kInteractive,
+  kObservedDomContentLoaded,
+  kObservedFirstVisualChange,
+  kObservedLoad,
+  kDocumentRequestCount,
+  kDocumentSize,
+  kFontRequestCount,
+  kFontSize,
+  kImageRequestCount,
+  kImageSize,
+  kMediaRequestCount,
+  kMediaSize,
+  kOtherRequestCount,
+  kOtherSize,
+  kScriptRequestCount,
+  kScriptSize,
+  kStylesheetRequestCount,
+  kStylesheetSize,
+  kThirdPartyRequestCount,
+  kThirdPartySize,
+  kTotalRequestCount,
+  kTotalSize,
+  kFirstThirdPartyBlocked,
+};
+
+static_assert(kFirstThirdPartyBlocked == standardise_feat_count,
+              "Only the standardised features have named slots");
+static_assert(kFirstThirdPartyBlocked +
+                      std::tuple_size<decltype(relevant_entities)>::value ==
+                  feature_count,
+              "Every remaining feature is a blocked third party");
+
 constexpr double kOutlierThreshold = 6;
 // if above 20MB _and_ more than 6x of the transfer size, probably an outlier
 constexpr double kSavingsAbsoluteOutlier = 20 << 20;
@@ -21,7 +67,7 @@ constexpr double kSavingsAbsoluteOutlier = 20 << 20;
 // Computes prediction based on the provided feature vector.
 // It is the client's responsibility to provide features in
 // the exact order expected by the predictor.
-double LinregPredictVector(const std::array<double, feature_count>& features);
+double LinregPredictVector(const FeatureVector& features);
 
 // Computes prediction based on key-value map of features.
 // It translates the map to a feature vector internally, and
@@ -31,6 +77,10 @@ double LinregPredictVector(const std::array<double, feature_count>& features);
 // any extra features.
 double LinregPredictNamed(const base::flat_map<std::string, double>& features);
 
+// Returns the slot of the "thirdParties.<entity>.blocked" feature, or nullopt
+// if the model doesn't know |entity|.
+base::Optional<size_t> ThirdPartyBlockedFeatureSlot(base::StringPiece entity);
+
 }  // namespace brave_perf_predictor
 
 #endif  // BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_H_
@@ -105,4 +105,51 @@ TEST(BraveSavingsPredictorTest, HandesSpecificFeaturemapExample) {
             794);  // Equal on the order of thousands
 }
 
+TEST(BraveSavingsPredictorTest, FeatureSlotsMatchFeatureSequence) {
+  EXPECT_EQ("adblockRequests", feature_sequence[kAdblockRequests]);
+  EXPECT_EQ("metrics.firstMeaningfulPaint",
+            feature_sequence[kFirstMeaningfulPaint]);
+  EXPECT_EQ("metrics.interactive", feature_sequence[kInteractive]);
+  EXPECT_EQ("metrics.observedDomContentLoaded",
+            feature_sequence[kObservedDomContentLoaded]);
+  EXPECT_EQ("metrics.observedFirstVisualChange",
+            feature_sequence[kObservedFirstVisualChange]);
+  EXPECT_EQ("metrics.observedLoad", feature_sequence[kObservedLoad]);
+  EXPECT_EQ("resources.document.requestCount",
+            feature_sequence[kDocumentRequestCount]);
+  EXPECT_EQ("resources.document.size", feature_sequence[kDocumentSize]);
+  EXPECT_EQ("resources.font.requestCount",
+            feature_sequence[kFontRequestCount]);
+  EXPECT_EQ("resources.font.size", feature_sequence[kFontSize]);
+  EXPECT_EQ("resources.image.requestCount",
+            feature_sequence[kImageRequestCount]);
+  EXPECT_EQ("resources.image.size", feature_sequence[kImageSize]);
+  EXPECT_EQ("resources.media.requestCount",
+            feature_sequence[kMediaRequestCount]);
+  EXPECT_EQ("resources.media.size", feature_sequence[kMediaSize]);
+  EXPECT_EQ("resources.other.requestCount",
+            feature_sequence[kOtherRequestCount]);
+  EXPECT_EQ("resources.other.size", feature_sequence[kOtherSize]);
+  EXPECT_EQ("resources.script.requestCount",
+            feature_sequence[kScriptRequestCount]);
+  EXPECT_EQ("resources.script.size", feature_sequence[kScriptSize]);
+  EXPECT_EQ("resources.stylesheet.requestCount",
+            feature_sequence[kStylesheetRequestCount]);
+  EXPECT_EQ("resources.stylesheet.size", feature_sequence[kStylesheetSize]);
+  EXPECT_EQ("resources.third-party.requestCount",
+            feature_sequence[kThirdPartyRequestCount]);
+  EXPECT_EQ("resources.third-party.size", feature_sequence[kThirdPartySize]);
+  EXPECT_EQ("resources.total.requestCount",
+            feature_sequence[kTotalRequestCount]);
+  EXPECT_EQ("resources.total.size", feature_sequence[kTotalSize]);
+
+  for (const std::string& entity : relevant_entities) {
+    const base::Optional<size_t> slot = ThirdPartyBlockedFeatureSlot(entity);
+    ASSERT_TRUE(slot.has_value()) << entity;
+    EXPECT_EQ("thirdParties." + entity + ".blocked",
+              feature_sequence[slot.value()]);
+  }
+  EXPECT_FALSE(ThirdPartyBlockedFeatureSlot("Not A Third Party").has_value());
+}
+
 }  // namespace brave_perf_predictor
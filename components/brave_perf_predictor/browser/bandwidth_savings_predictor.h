@@ -8,8 +8,8 @@
 
 #include <string>
 
-#include "base/containers/flat_map.h"
 #include "base/gtest_prod_util.h"
+#include "brave/components/brave_perf_predictor/browser/bandwidth_linreg.h"
 #include "url/gurl.h"
 
 namespace page_load_metrics {
@@ -60,9 +60,14 @@ class BandwidthSavingsPredictor {
   FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest, FeaturiseTiming);
   FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest,
                            FeaturiseResourceLoading);
+  FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest,
+                           PredictionMatchesNamedFeatures);
 
   GURL main_frame_url_;
-  base::flat_map<std::string, double> feature_map_;
+  // Model features, indexed by |FeatureSlot|.
+  FeatureVector features_{};
+  // Not a model feature, only used to sanity check predictions.
+  double transfer_total_size_ = 0;
 };
 
 }  // namespace brave_perf_predictor
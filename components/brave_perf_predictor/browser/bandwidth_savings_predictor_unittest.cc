@@ -5,8 +5,12 @@
 
 #include "brave/components/brave_perf_predictor/browser/bandwidth_savings_predictor.h"
 
+#include <string>
+
 #include "base/containers/flat_map.h"
 #include "base/time/time.h"
+#include "brave/components/brave_perf_predictor/browser/bandwidth_linreg.h"
+#include "brave/components/brave_perf_predictor/browser/named_third_party_registry.h"
 #include "chrome/browser/predictors/loading_test_util.h"
 #include "components/page_load_metrics/common/page_load_metrics.mojom.h"
 #include "components/page_load_metrics/common/page_load_timing.h"
@@ -16,56 +20,79 @@
 
 namespace brave_perf_predictor {
 
-TEST(BandwidthSavingsPredictorTest, FeaturiseBlocked) {
+namespace {
+
+constexpr char kThirdParties[] = R"([
+  {"name": "Google Analytics", "domains": ["google-analytics.com"]},
+  {"name": "Facebook", "domains": ["m.facebook.com", "connect.facebook.net"]}
+])";
+
+}  // namespace
+
+class BandwidthSavingsPredictorTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    NamedThirdPartyRegistry::GetInstance()->ResetForTesting();
+  }
+
+  void LoadThirdParties() {
+    ASSERT_TRUE(NamedThirdPartyRegistry::GetInstance()->LoadMappings(
+        kThirdParties, false));
+  }
+};
+
+TEST_F(BandwidthSavingsPredictorTest, FeaturiseBlocked) {
+  LoadThirdParties();
   BandwidthSavingsPredictor predictor;
   predictor.OnSubresourceBlocked("https://google-analytics.com");
-  EXPECT_EQ(predictor.feature_map_["adblockRequests"], 1);
-  EXPECT_EQ(predictor.feature_map_["thirdParties.Google Analytics.blocked"],
+  EXPECT_EQ(predictor.features_[kAdblockRequests], 1);
+  EXPECT_EQ(predictor.features_[ThirdPartyBlockedFeatureSlot("Google Analytics")
+                                    .value()],
             1);
   predictor.OnSubresourceBlocked("https://test.m.facebook.com");
-  EXPECT_EQ(predictor.feature_map_["adblockRequests"], 2);
+  EXPECT_EQ(predictor.features_[kAdblockRequests], 2);
 }
 
-TEST(BandwidthSavingsPredictorTest, FeaturiseTiming) {
+TEST_F(BandwidthSavingsPredictorTest, FeaturiseTiming) {
   BandwidthSavingsPredictor predictor;
   const auto empty_timing = page_load_metrics::CreatePageLoadTiming();
   predictor.OnPageLoadTimingUpdated(*empty_timing);
-  EXPECT_EQ(predictor.feature_map_["metrics.firstMeaningfulPaint"], 0);
-  EXPECT_EQ(predictor.feature_map_["metrics.observedDomContentLoaded"], 0);
-  EXPECT_EQ(predictor.feature_map_["metrics.observedFirstVisualChange"], 0);
-  EXPECT_EQ(predictor.feature_map_["metrics.observedLoad"], 0);
-  EXPECT_EQ(predictor.feature_map_["metrics.interactive"], 0);
+  EXPECT_EQ(predictor.features_[kFirstMeaningfulPaint], 0);
+  EXPECT_EQ(predictor.features_[kObservedDomContentLoaded], 0);
+  EXPECT_EQ(predictor.features_[kObservedFirstVisualChange], 0);
+  EXPECT_EQ(predictor.features_[kObservedLoad], 0);
+  EXPECT_EQ(predictor.features_[kInteractive], 0);
 
   auto timing = page_load_metrics::CreatePageLoadTiming();
   timing->document_timing->dom_content_loaded_event_start =
       base::TimeDelta::FromMilliseconds(1000);
   predictor.OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor.feature_map_["metrics.observedDomContentLoaded"], 1000);
+  EXPECT_EQ(predictor.features_[kObservedDomContentLoaded], 1000);
 
   timing->document_timing->load_event_start =
       base::TimeDelta::FromMilliseconds(2000);
   predictor.OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor.feature_map_["metrics.observedLoad"], 2000);
+  EXPECT_EQ(predictor.features_[kObservedLoad], 2000);
 
   timing->paint_timing->first_meaningful_paint =
       base::TimeDelta::FromMilliseconds(1500);
   predictor.OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor.feature_map_["metrics.firstMeaningfulPaint"], 1500);
+  EXPECT_EQ(predictor.features_[kFirstMeaningfulPaint], 1500);
 
   timing->paint_timing->first_contentful_paint =
       base::TimeDelta::FromMilliseconds(800);
   predictor.OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor.feature_map_["metrics.observedFirstVisualChange"], 800);
+  EXPECT_EQ(predictor.features_[kObservedFirstVisualChange], 800);
 
   timing->interactive_timing->interactive =
       base::TimeDelta::FromMilliseconds(2500);
   predictor.OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor.feature_map_["metrics.interactive"], 2500);
+  EXPECT_EQ(predictor.features_[kInteractive], 2500);
 }
 
-TEST(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
+TEST_F(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
   BandwidthSavingsPredictor predictor;
-  EXPECT_EQ(predictor.feature_map_["resources.third-party.requestCount"], 0);
+  EXPECT_EQ(predictor.features_[kThirdPartyRequestCount], 0);
 
   const GURL main_frame("https://brave.com/");
 
@@ -73,9 +100,9 @@ TEST(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
       "https://brave.com/style.css", content::ResourceType::kStylesheet);
   fp_style->raw_body_bytes = 1000;
   predictor.OnResourceLoadComplete(main_frame, *fp_style);
-  EXPECT_EQ(predictor.feature_map_["resources.third-party.requestCount"], 0);
-  EXPECT_EQ(predictor.feature_map_["resources.stylesheet.requestCount"], 1);
-  EXPECT_EQ(predictor.feature_map_["resources.stylesheet.size"], 1000);
+  EXPECT_EQ(predictor.features_[kThirdPartyRequestCount], 0);
+  EXPECT_EQ(predictor.features_[kStylesheetRequestCount], 1);
+  EXPECT_EQ(predictor.features_[kStylesheetSize], 1000);
 
   auto tp_style = predictors::CreateResourceLoadInfo(
       "https://stackpath.bootstrapcdn.com/bootstrap/4.4.1/css/bootstrap.min.js",
@@ -83,22 +110,22 @@ TEST(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
   tp_style->raw_body_bytes = 1001;
   predictor.OnResourceLoadComplete(main_frame, *tp_style);
 
-  EXPECT_EQ(predictor.feature_map_["resources.third-party.requestCount"], 1);
-  EXPECT_EQ(predictor.feature_map_["resources.stylesheet.requestCount"], 1);
-  EXPECT_EQ(predictor.feature_map_["resources.script.requestCount"], 1);
-  EXPECT_EQ(predictor.feature_map_["resources.stylesheet.size"], 1000);
-  EXPECT_EQ(predictor.feature_map_["resources.script.size"], 1001);
+  EXPECT_EQ(predictor.features_[kThirdPartyRequestCount], 1);
+  EXPECT_EQ(predictor.features_[kStylesheetRequestCount], 1);
+  EXPECT_EQ(predictor.features_[kScriptRequestCount], 1);
+  EXPECT_EQ(predictor.features_[kStylesheetSize], 1000);
+  EXPECT_EQ(predictor.features_[kScriptSize], 1001);
 
-  EXPECT_EQ(predictor.feature_map_["resources.total.requestCount"], 2);
-  EXPECT_EQ(predictor.feature_map_["resources.total.size"], 2001);
+  EXPECT_EQ(predictor.features_[kTotalRequestCount], 2);
+  EXPECT_EQ(predictor.features_[kTotalSize], 2001);
 }
 
-TEST(BandwidthSavingsPredictorTest, PredictZeroNoData) {
+TEST_F(BandwidthSavingsPredictorTest, PredictZeroNoData) {
   BandwidthSavingsPredictor predictor;
   EXPECT_EQ(predictor.PredictSavingsBytes(), 0);
 }
 
-TEST(BandwidthSavingsPredictorTest, PredictZeroInternalUrl) {
+TEST_F(BandwidthSavingsPredictorTest, PredictZeroInternalUrl) {
   BandwidthSavingsPredictor predictor;
 
   const GURL main_frame("brave://version");
@@ -108,7 +135,7 @@ TEST(BandwidthSavingsPredictorTest, PredictZeroInternalUrl) {
   EXPECT_EQ(predictor.PredictSavingsBytes(), 0);
 }
 
-TEST(BandwidthSavingsPredictorTest, PredictZeroBadFrame) {
+TEST_F(BandwidthSavingsPredictorTest, PredictZeroBadFrame) {
   BandwidthSavingsPredictor predictor;
 
   const GURL main_frame("");
@@ -120,7 +147,7 @@ TEST(BandwidthSavingsPredictorTest, PredictZeroBadFrame) {
   EXPECT_EQ(predictor.PredictSavingsBytes(), 0);
 }
 
-TEST(BandwidthSavingsPredictorTest, PredictZeroNoBlocks) {
+TEST_F(BandwidthSavingsPredictorTest, PredictZeroNoBlocks) {
   BandwidthSavingsPredictor predictor;
 
   const GURL main_frame("https://brave.com");
@@ -132,7 +159,7 @@ TEST(BandwidthSavingsPredictorTest, PredictZeroNoBlocks) {
   EXPECT_EQ(predictor.PredictSavingsBytes(), 0);
 }
 
-TEST(BandwidthSavingsPredictorTest, PredictNonZero) {
+TEST_F(BandwidthSavingsPredictorTest, PredictNonZero) {
   BandwidthSavingsPredictor predictor;
 
   const GURL main_frame("https://brave.com");
@@ -152,4 +179,76 @@ TEST(BandwidthSavingsPredictorTest, PredictNonZero) {
   EXPECT_NE(predictor.PredictSavingsBytes(), 0);
 }
 
+TEST_F(BandwidthSavingsPredictorTest, PredictionMatchesNamedFeatures) {
+  LoadThirdParties();
+  BandwidthSavingsPredictor predictor;
+
+  const GURL main_frame("https://brave.com");
+  auto timing = page_load_metrics::CreatePageLoadTiming();
+  timing->document_timing->dom_content_loaded_event_start =
+      base::TimeDelta::FromMilliseconds(225);
+  timing->document_timing->load_event_start =
+      base::TimeDelta::FromMilliseconds(925);
+  timing->paint_timing->first_meaningful_paint =
+      base::TimeDelta::FromMilliseconds(129);
+  timing->paint_timing->first_contentful_paint =
+      base::TimeDelta::FromMilliseconds(142);
+  timing->interactive_timing->interactive =
+      base::TimeDelta::FromMilliseconds(225);
+  predictor.OnPageLoadTimingUpdated(*timing);
+
+  auto document = predictors::CreateResourceLoadInfo(
+      "https://brave.com/", content::ResourceType::kMainFrame);
+  document->raw_body_bytes = 34662;
+  document->total_received_bytes = 35000;
+  predictor.OnResourceLoadComplete(main_frame, *document);
+  auto script = predictors::CreateResourceLoadInfo(
+      "https://cdn.example.com/app.js", content::ResourceType::kScript);
+  script->raw_body_bytes = 238315;
+  script->total_received_bytes = 240000;
+  predictor.OnResourceLoadComplete(main_frame, *script);
+  auto image = predictors::CreateResourceLoadInfo(
+      "https://brave.com/logo.png", content::ResourceType::kImage);
+  image->raw_body_bytes = 1702888;
+  image->total_received_bytes = 1710000;
+  predictor.OnResourceLoadComplete(main_frame, *image);
+  predictor.OnSubresourceBlocked("https://google-analytics.com/ga.js");
+  predictor.OnSubresourceBlocked("https://connect.facebook.net/sdk.js");
+
+  // The same page described by name, the way features used to be collected
+  // before they had fixed slots.
+  const base::flat_map<std::string, double> named_features = {
+      {"adblockRequests", 2},
+      {"thirdParties.Google Analytics.blocked", 1},
+      {"thirdParties.Facebook.blocked", 1},
+      {"metrics.firstMeaningfulPaint", 129},
+      {"metrics.interactive", 225},
+      {"metrics.observedDomContentLoaded", 225},
+      {"metrics.observedFirstVisualChange", 142},
+      {"metrics.observedLoad", 925},
+      {"resources.document.requestCount", 1},
+      {"resources.document.size", 34662},
+      {"resources.image.requestCount", 1},
+      {"resources.image.size", 1702888},
+      {"resources.script.requestCount", 1},
+      {"resources.script.size", 238315},
+      {"resources.third-party.requestCount", 1},
+      {"resources.third-party.size", 238315},
+      {"resources.total.requestCount", 3},
+      {"resources.total.size", 1975865},
+      // Not a model feature, ignored by the prediction.
+      {"transfer.total.size", 1985000},
+  };
+  for (size_t i = 0; i < feature_count; ++i) {
+    const auto it = named_features.find(feature_sequence[i]);
+    EXPECT_EQ(it != named_features.end() ? it->second : 0,
+              predictor.features_[i])
+        << feature_sequence[i];
+  }
+
+  const double prediction = predictor.PredictSavingsBytes();
+  EXPECT_NE(0, prediction);
+  EXPECT_DOUBLE_EQ(LinregPredictNamed(named_features), prediction);
+}
+
 }  // namespace brave_perf_predictor
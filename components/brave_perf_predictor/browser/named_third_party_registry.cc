@@ -5,12 +5,16 @@
 
 #include "brave/components/brave_perf_predictor/browser/named_third_party_registry.h"
 
+#include <limits>
+#include <utility>
+
+#include "base/bind.h"
 #include "base/containers/flat_set.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
-#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
+#include "base/task/post_task.h"
 #include "base/values.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 #include "components/grit/brave_components_resources.h"
@@ -20,34 +24,68 @@
 
 namespace brave_perf_predictor {
 
+NamedThirdPartyRegistry::Mappings::Mappings() = default;
+NamedThirdPartyRegistry::Mappings::Mappings(Mappings&&) = default;
+NamedThirdPartyRegistry::Mappings& NamedThirdPartyRegistry::Mappings::
+operator=(Mappings&&) = default;
+NamedThirdPartyRegistry::Mappings::~Mappings() = default;
+
 // static
 NamedThirdPartyRegistry* NamedThirdPartyRegistry::GetInstance() {
-  auto* extractor = base::Singleton<NamedThirdPartyRegistry>::get();
-  // By default initialize from packaged resources
-  if (!extractor->IsInitialized()) {
-    bool initialized = extractor->InitializeFromResource();
-    if (!initialized) {
-      VLOG(2) << "Initialization from resource failed, marking as initialized "
-              << "will not retry";
-      extractor->MarkInitialized(true);
-    }
-  }
-  return extractor;
+  return base::Singleton<NamedThirdPartyRegistry>::get();
+}
+
+void NamedThirdPartyRegistry::InitializeDefault() {
+  if (initialized_ || loading_)
+    return;
+  loading_ = true;
+  // By default initialize from packaged resources. The singleton is leaked
+  // on shutdown, but a weak pointer keeps an instance created in tests (or a
+  // reset one) from receiving a stale reply.
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      {base::ThreadPool(), base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::BindOnce(&NamedThirdPartyRegistry::ParseMappingsFromResource),
+      base::BindOnce(&NamedThirdPartyRegistry::OnMappingsLoaded,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void NamedThirdPartyRegistry::ResetForTesting() {
+  weak_factory_.InvalidateWeakPtrs();
+  mappings_ = Mappings();
+  initialized_ = false;
+  loading_ = false;
 }
 
 bool NamedThirdPartyRegistry::LoadMappings(const base::StringPiece entities,
                                            bool discard_irrelevant) {
+  base::Optional<Mappings> mappings =
+      ParseMappings(entities, discard_irrelevant);
   // Reset previous mappings
-  entity_by_domain_.clear();
-  entity_by_root_domain_.clear();
+  mappings_ = mappings ? std::move(mappings.value()) : Mappings();
+  if (!mappings)
+    return false;
+
+  initialized_ = true;
+  return true;
+}
 
+// static
+base::Optional<NamedThirdPartyRegistry::Mappings>
+NamedThirdPartyRegistry::ParseMappings(const base::StringPiece entities,
+                                       bool discard_irrelevant) {
   // Parse the JSON
   base::Optional<base::Value> document = base::JSONReader::Read(entities);
   if (!document || !document->is_list()) {
     LOG(ERROR) << "Cannot parse the third-party entities list";
-    return false;
+    return base::nullopt;
   }
 
+  Mappings mappings;
+  std::vector<std::pair<std::string, uint16_t>> entity_by_domain;
+  base::flat_map<std::string, uint16_t> entity_by_root_domain;
+
   // Collect the mappings
   for (auto& entity : document->GetList()) {
     const std::string* entity_name = entity.FindStringPath("name");
@@ -61,59 +99,108 @@ bool NamedThirdPartyRegistry::LoadMappings(const base::StringPiece entities,
     if (!entity_domains)
       continue;
 
+    if (mappings.entities.size() > std::numeric_limits<uint16_t>::max()) {
+      LOG(ERROR) << "Too many third-party entities";
+      return base::nullopt;
+    }
+    const uint16_t entity_index = mappings.entities.size();
+    mappings.entities.push_back(*entity_name);
+
     for (auto& entity_domain_it : entity_domains->GetList()) {
       if (!entity_domain_it.is_string()) {
         continue;
       }
       const base::StringPiece entity_domain(entity_domain_it.GetString());
+      entity_by_domain.emplace_back(entity_domain.as_string(), entity_index);
 
-      const auto inserted =
-          entity_by_domain_.emplace(entity_domain, *entity_name);
-      if (!inserted.second) {
-        VLOG(2) << "Malformed data: duplicate domain " << entity_domain;
-      }
       auto root_domain = net::registry_controlled_domains::GetDomainAndRegistry(
           entity_domain,
           net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
 
-      auto root_entity_entry = entity_by_root_domain_.find(root_domain);
-      if (root_entity_entry != entity_by_root_domain_.end() &&
-          root_entity_entry->second != *entity_name) {
+      auto root_entity_entry = entity_by_root_domain.find(root_domain);
+      if (root_entity_entry != entity_by_root_domain.end() &&
+          root_entity_entry->second != entity_index) {
         // If there is a clash at root domain level, neither is correct
-        entity_by_root_domain_.erase(root_entity_entry);
+        entity_by_root_domain.erase(root_entity_entry);
       } else {
-        entity_by_root_domain_.emplace(root_domain, *entity_name);
+        entity_by_root_domain.emplace(root_domain, entity_index);
       }
     }
   }
 
-  entity_by_domain_.shrink_to_fit();
-  entity_by_root_domain_.shrink_to_fit();
-  VLOG(2) << "Loaded " << entity_by_domain_.size() << " mappings by domain and "
-          << entity_by_root_domain_.size() << " by root domain; size";
-  initialized_ = true;
+  // Build the domain index in one go, keeping the first entity for
+  // duplicate domains.
+  const size_t domain_count = entity_by_domain.size();
+  mappings.entity_by_domain =
+      base::flat_map<std::string, uint16_t>(std::move(entity_by_domain));
+  if (mappings.entity_by_domain.size() != domain_count) {
+    VLOG(2) << "Malformed data: "
+            << domain_count - mappings.entity_by_domain.size()
+            << " duplicate domains";
+  }
+  mappings.entity_by_root_domain = std::move(entity_by_root_domain);
+  mappings.entity_by_domain.shrink_to_fit();
+  mappings.entity_by_root_domain.shrink_to_fit();
+  VLOG(2) << "Loaded " << mappings.entity_by_domain.size()
+          << " mappings by domain and "
+          << mappings.entity_by_root_domain.size() << " by root domain";
+
+  return mappings;
+}
 
-  return true;
+// static
+base::Optional<NamedThirdPartyRegistry::Mappings>
+NamedThirdPartyRegistry::ParseMappingsFromResource() {
+  const auto resource_id = IDR_THIRD_PARTY_ENTITIES;
+  // TODO(AndriusA): insert trace event here
+  SCOPED_UMA_HISTOGRAM_TIMER(
+      "Brave.Savings.NamedThirdPartyRegistry.LoadTimeMS");
+  auto& resource_bundle = ui::ResourceBundle::GetSharedInstance();
+  std::string data_resource =
+      resource_bundle.LoadDataResourceString(resource_id);
+  // Parse resource, discarding irrelevant entities
+  return ParseMappings(data_resource, true);
+}
+
+void NamedThirdPartyRegistry::OnMappingsLoaded(
+    base::Optional<Mappings> mappings) {
+  loading_ = false;
+  // Mappings loaded directly in the meantime take precedence.
+  if (initialized_)
+    return;
+  if (mappings) {
+    mappings_ = std::move(mappings.value());
+  } else {
+    VLOG(2) << "Initialization from resource failed, marking as initialized "
+            << "will not retry";
+  }
+  initialized_ = true;
 }
 
 base::Optional<std::string> NamedThirdPartyRegistry::GetThirdParty(
     const base::StringPiece request_url) const {
   const GURL url(request_url);
-  if (!url.is_valid())
+  if (!url.is_valid() || !url.has_host())
+    return base::nullopt;
+
+  return GetThirdPartyForHost(url.host_piece());
+}
+
+base::Optional<std::string> NamedThirdPartyRegistry::GetThirdPartyForHost(
+    const base::StringPiece host) const {
+  if (mappings_.entities.empty())
     return base::nullopt;
 
-  if (url.has_host()) {
-    auto domain_entry = entity_by_domain_.find(url.host());
-    if (domain_entry != entity_by_domain_.end())
-      return domain_entry->second;
+  auto domain_entry = mappings_.entity_by_domain.find(host);
+  if (domain_entry != mappings_.entity_by_domain.end())
+    return mappings_.entities[domain_entry->second];
 
-    auto root_domain = net::registry_controlled_domains::GetDomainAndRegistry(
-        url, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  auto root_domain = net::registry_controlled_domains::GetDomainAndRegistry(
+      host, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
 
-    auto root_domain_entry = entity_by_root_domain_.find(root_domain);
-    if (root_domain_entry != entity_by_root_domain_.end())
-      return root_domain_entry->second;
-  }
+  auto root_domain_entry = mappings_.entity_by_root_domain.find(root_domain);
+  if (root_domain_entry != mappings_.entity_by_root_domain.end())
+    return mappings_.entities[root_domain_entry->second];
 
   return base::nullopt;
 }
@@ -122,16 +209,4 @@ NamedThirdPartyRegistry::NamedThirdPartyRegistry() = default;
 
 NamedThirdPartyRegistry::~NamedThirdPartyRegistry() = default;
 
-bool NamedThirdPartyRegistry::InitializeFromResource() {
-  const auto resource_id = IDR_THIRD_PARTY_ENTITIES;
-  // TODO(AndriusA): insert trace event here
-  SCOPED_UMA_HISTOGRAM_TIMER(
-      "Brave.Savings.NamedThirdPartyRegistry.LoadTimeMS");
-  auto& resource_bundle = ui::ResourceBundle::GetSharedInstance();
-  std::string data_resource =
-      resource_bundle.LoadDataResourceString(resource_id);
-  // Parse resource, discarding irrelevant entities
-  return LoadMappings(data_resource, true);
-}
-
 }  // namespace brave_perf_predictor
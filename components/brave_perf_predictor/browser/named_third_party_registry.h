@@ -6,44 +6,84 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_REGISTRY_H_
 #define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_REGISTRY_H_
 
+#include <stdint.h>
+
 #include <string>
+#include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/gtest_prod_util.h"
+#include "base/memory/weak_ptr.h"
 #include "base/memory/singleton.h"
-#include "base/values.h"
+#include "base/optional.h"
+#include "base/strings/string_piece.h"
 
 namespace brave_perf_predictor {
 
 // Retrieves publicly known Third Party (organisation) for a given URL, using
 // data from the Third Party Web repository
 // (https://github.com/patrickhulce/third-party-web).
+// Lives on the UI thread, only parsing happens elsewhere.
 class NamedThirdPartyRegistry {
  public:
   NamedThirdPartyRegistry(const NamedThirdPartyRegistry&) = delete;
   NamedThirdPartyRegistry& operator=(const NamedThirdPartyRegistry&) = delete;
   static NamedThirdPartyRegistry* GetInstance();
 
+  // Starts parsing the packaged mappings on a background sequence, unless
+  // that has already happened. Lookups find nothing until it completes.
+  void InitializeDefault();
+
   // Parse the provided mappings (in JSON format), potentially discarding
   // entities not relevant to the bandwith prediction model (i.e. those not
   // seen in training the model).
   bool LoadMappings(const base::StringPiece entities,
                     bool discard_irrelevant);
   base::Optional<std::string> GetThirdParty(
-      const base::StringPiece domain) const;
+      const base::StringPiece request_url) const;
+  // Same as |GetThirdParty| for a host that was already extracted from the
+  // request URL.
+  base::Optional<std::string> GetThirdPartyForHost(
+      const base::StringPiece host) const;
+
+  bool IsInitialized() const { return initialized_; }
+
+  // Drops all mappings and any pending load, so that tests loading their own
+  // mappings don't leak them into other tests sharing the singleton.
+  void ResetForTesting();
 
  private:
   friend struct base::DefaultSingletonTraits<NamedThirdPartyRegistry>;
+  FRIEND_TEST_ALL_PREFIXES(NamedThirdPartyRegistryTest,
+                           LookupsBeforeLoadCompletes);
+
+  // Entity names are stored once and referenced by index from the domain
+  // indices.
+  struct Mappings {
+    Mappings();
+    Mappings(Mappings&&);
+    Mappings& operator=(Mappings&&);
+    ~Mappings();
+
+    std::vector<std::string> entities;
+    base::flat_map<std::string, uint16_t> entity_by_domain;
+    base::flat_map<std::string, uint16_t> entity_by_root_domain;
+  };
 
   NamedThirdPartyRegistry();
   ~NamedThirdPartyRegistry();
 
-  bool IsInitialized() const { return initialized_; }
-  void MarkInitialized(bool initialized) { initialized_ = initialized; }
-  bool InitializeFromResource();
+  static base::Optional<Mappings> ParseMappings(
+      const base::StringPiece entities,
+      bool discard_irrelevant);
+  static base::Optional<Mappings> ParseMappingsFromResource();
+  void OnMappingsLoaded(base::Optional<Mappings> mappings);
 
   bool initialized_ = false;
-  base::flat_map<std::string, std::string> entity_by_domain_;
-  base::flat_map<std::string, std::string> entity_by_root_domain_;
+  bool loading_ = false;
+  Mappings mappings_;
+
+  base::WeakPtrFactory<NamedThirdPartyRegistry> weak_factory_{this};
 };
 
 }  // namespace brave_perf_predictor
@@ -8,6 +8,7 @@
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/path_service.h"
+#include "base/test/task_environment.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace brave_perf_predictor {
@@ -55,32 +56,39 @@ std::string LoadFile() {
 
 }  // namespace
 
-TEST(NamedThirdPartyRegistryTest, HandlesEmptyJSON) {
+class NamedThirdPartyRegistryTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    NamedThirdPartyRegistry::GetInstance()->ResetForTesting();
+  }
+};
+
+TEST_F(NamedThirdPartyRegistryTest, HandlesEmptyJSON) {
   NamedThirdPartyRegistry* extractor = NamedThirdPartyRegistry::GetInstance();
   bool parsed = extractor->LoadMappings("", false);
   EXPECT_FALSE(parsed);
 }
 
-TEST(NamedThirdPartyRegistryTest, ParsesJSON) {
+TEST_F(NamedThirdPartyRegistryTest, ParsesJSON) {
   NamedThirdPartyRegistry* extractor = NamedThirdPartyRegistry::GetInstance();
   bool parsed = extractor->LoadMappings(test_mapping, false);
   EXPECT_TRUE(parsed);
 }
 
-TEST(NamedThirdPartyRegistryTest, HandlesInvalidJSON) {
+TEST_F(NamedThirdPartyRegistryTest, HandlesInvalidJSON) {
   NamedThirdPartyRegistry* extractor = NamedThirdPartyRegistry::GetInstance();
   bool parsed = extractor->LoadMappings(R"([{"name":"Google Analytics")", false);
   EXPECT_FALSE(parsed);
 }
 
-TEST(NamedThirdPartyRegistryTest, HandlesFullDataset) {
+TEST_F(NamedThirdPartyRegistryTest, HandlesFullDataset) {
   NamedThirdPartyRegistry* extractor = NamedThirdPartyRegistry::GetInstance();
   auto dataset = LoadFile();
   bool parsed = extractor->LoadMappings(dataset, true);
   EXPECT_TRUE(parsed);
 }
 
-TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyURLTest) {
+TEST_F(NamedThirdPartyRegistryTest, ExtractsThirdPartyURLTest) {
   NamedThirdPartyRegistry* extractor = NamedThirdPartyRegistry::GetInstance();
   auto dataset = LoadFile();
   extractor->LoadMappings(dataset, true);
@@ -90,7 +98,7 @@ TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyURLTest) {
   EXPECT_EQ(entity.value(), "Google Analytics");
 }
 
-TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyHostnameTest) {
+TEST_F(NamedThirdPartyRegistryTest, ExtractsThirdPartyHostnameTest) {
   NamedThirdPartyRegistry* extractor = NamedThirdPartyRegistry::GetInstance();
   auto dataset = LoadFile();
   extractor->LoadMappings(dataset, true);
@@ -99,7 +107,7 @@ TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyHostnameTest) {
   EXPECT_EQ(entity.value(), "Google Analytics");
 }
 
-TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyRootDomainTest) {
+TEST_F(NamedThirdPartyRegistryTest, ExtractsThirdPartyRootDomainTest) {
   NamedThirdPartyRegistry* extractor = NamedThirdPartyRegistry::GetInstance();
   auto dataset = LoadFile();
   extractor->LoadMappings(dataset, true);
@@ -108,7 +116,7 @@ TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyRootDomainTest) {
   EXPECT_EQ(entity.value(), "Facebook");
 }
 
-TEST(NamedThirdPartyRegistryTest, HandlesUnrecognisedThirdPartyTest) {
+TEST_F(NamedThirdPartyRegistryTest, HandlesUnrecognisedThirdPartyTest) {
   NamedThirdPartyRegistry* extractor = NamedThirdPartyRegistry::GetInstance();
   auto dataset = LoadFile();
   extractor->LoadMappings(dataset, true);
@@ -116,4 +124,36 @@ TEST(NamedThirdPartyRegistryTest, HandlesUnrecognisedThirdPartyTest) {
   EXPECT_FALSE(entity.has_value());
 }
 
+TEST_F(NamedThirdPartyRegistryTest, ExtractsThirdPartyFromHostTest) {
+  NamedThirdPartyRegistry* extractor = NamedThirdPartyRegistry::GetInstance();
+  extractor->LoadMappings(test_mapping, false);
+  auto entity = extractor->GetThirdPartyForHost("connect.facebook.net");
+  ASSERT_TRUE(entity.has_value());
+  EXPECT_EQ(entity.value(), "Facebook");
+  entity = extractor->GetThirdPartyForHost("test.m.facebook.com");
+  ASSERT_TRUE(entity.has_value());
+  EXPECT_EQ(entity.value(), "Facebook");
+  EXPECT_FALSE(extractor->GetThirdPartyForHost("example.com").has_value());
+}
+
+TEST_F(NamedThirdPartyRegistryTest, LookupsBeforeLoadCompletes) {
+  base::test::TaskEnvironment task_environment;
+  NamedThirdPartyRegistry registry;
+  registry.InitializeDefault();
+
+  // Until the packaged mappings are parsed nothing is recognised, but
+  // lookups keep working.
+  EXPECT_FALSE(registry.IsInitialized());
+  EXPECT_FALSE(
+      registry.GetThirdParty("https://google-analytics.com/ga.js").has_value());
+  EXPECT_FALSE(
+      registry.GetThirdPartyForHost("google-analytics.com").has_value());
+
+  task_environment.RunUntilIdle();
+  EXPECT_TRUE(registry.IsInitialized());
+  auto entity = registry.GetThirdParty("https://google-analytics.com/ga.js");
+  ASSERT_TRUE(entity.has_value());
+  EXPECT_EQ(entity.value(), "Google Analytics");
+}
+
 }  // namespace brave_perf_predictor
@@ -5,6 +5,7 @@
 
 #include "brave/components/brave_perf_predictor/browser/perf_predictor_tab_helper.h"
 
+#include "brave/components/brave_perf_predictor/browser/named_third_party_registry.h"
 #include "brave/components/brave_perf_predictor/common/pref_names.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
@@ -40,6 +41,9 @@ PerfPredictorTabHelper::PerfPredictorTabHelper(
     content::WebContents* web_contents)
     : WebContentsObserver(web_contents),
       bandwidth_predictor_(std::make_unique<BandwidthSavingsPredictor>()) {
+  // Get the third-party registry ready before the first page finishes.
+  NamedThirdPartyRegistry::GetInstance()->InitializeDefault();
+
   if (web_contents->GetBrowserContext()->IsOffTheRecord())
     return;
 
@@ -4,6 +4,7 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "base/path_service.h"
+#include "base/run_loop.h"
 #include "base/task/post_task.h"
 #include "base/test/thread_test_helper.h"
 #include "brave/browser/brave_browser_process_impl.h"
@@ -13,6 +14,7 @@
 #include "brave/components/brave_perf_predictor/common/pref_names.h"
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
+#include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/ui/browser.h"
 #include "chrome/test/base/in_process_browser_test.h"
@@ -31,6 +33,13 @@ uint64_t getProfileBandwidthSaved(Browser* browser) {
       brave_perf_predictor::prefs::kBandwidthSavedBytes);
 }
 
+// Blocked resources are counted in memory and flushed to prefs periodically.
+uint64_t getAdsBlocked(Browser* browser, content::WebContents* contents) {
+  brave_shields::BraveShieldsWebContentsObserver::FromWebContents(contents)
+      ->FlushBlockedEvents();
+  return browser->profile()->GetPrefs()->GetUint64(kAdsBlocked);
+}
+
 }  // namespace
 
 class PerfPredictorTabHelperTest : public InProcessBrowserTest {
@@ -66,9 +75,10 @@ class PerfPredictorTabHelperTest : public InProcessBrowserTest {
   }
 
   void WaitForAdBlockServiceThreads() {
-    scoped_refptr<base::ThreadTestHelper> tr_helper(new base::ThreadTestHelper(
-        g_brave_browser_process->local_data_files_service()->GetTaskRunner()));
-    ASSERT_TRUE(tr_helper->Run());
+    base::RunLoop run_loop;
+    g_brave_browser_process->local_data_files_service()->RunWhenReady(
+        run_loop.QuitClosure());
+    run_loop.Run();
     scoped_refptr<base::ThreadTestHelper> io_helper(new base::ThreadTestHelper(
         base::CreateSingleThreadTaskRunner({content::BrowserThread::IO})
             .get()));
@@ -110,7 +120,7 @@ IN_PROC_BROWSER_TEST_F(PerfPredictorTabHelperTest, ScriptBlockHasSavings) {
                                     "setExpectations(0, 0, 0, 0, 1, 0);"
                                     "xhr('analytics.js')")
                   .ExtractBool());
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(getAdsBlocked(browser(), contents), 1ULL);
   // Prediction triggered when web contents are closed
   contents->Close();
   EXPECT_NE(getProfileBandwidthSaved(browser()), 0ULL);
@@ -131,7 +141,7 @@ IN_PROC_BROWSER_TEST_F(PerfPredictorTabHelperTest, NewNavigationStoresSavings) {
                                     "setExpectations(0, 0, 0, 0, 1, 0);"
                                     "xhr('analytics.js')")
                   .ExtractBool());
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(getAdsBlocked(browser(), contents), 1ULL);
   // Prediction triggered when web contents are closed
   GURL second_url =
       embedded_test_server()->GetURL("example.com", "/blocking.html");
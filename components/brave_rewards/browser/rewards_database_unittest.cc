@@ -0,0 +1,722 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/task_environment.h"
+#include "base/timer/elapsed_timer.h"
+#include "bat/ledger/internal/database/database_activity_info.h"
+#include "bat/ledger/internal/database/database_server_publisher_banner.h"
+#include "bat/ledger/internal/database/database_server_publisher_info.h"
+#include "bat/ledger/internal/database/database_unblinded_token.h"
+#include "bat/ledger/internal/database/database_util.h"
+#include "bat/ledger/internal/ledger_client_mock.h"
+#include "bat/ledger/internal/ledger_impl_mock.h"
+#include "brave/components/brave_rewards/browser/rewards_database.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=RewardsDatabaseTest.*
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Invoke;
+
+namespace brave_rewards {
+
+namespace {
+
+const size_t kPublisherCount = 100000;
+
+const size_t kActivityCount = 50000;
+const int kActivityPageSize = 500;
+const uint64_t kReconcileStamp = 1000;
+
+const size_t kUnblindedTokenCount = 20000;
+const double kUnblindedTokenValue = 0.25;
+
+std::vector<ledger::ServerPublisherPartial> GetServerPublisherList(
+    const size_t count) {
+  std::vector<ledger::ServerPublisherPartial> list;
+  for (size_t i = 0; i < count; i++) {
+    ledger::ServerPublisherPartial publisher;
+    publisher.publisher_key = base::StringPrintf("publisher%zu.com", i);
+    publisher.status = ledger::PublisherStatus::VERIFIED;
+    publisher.excluded = false;
+    publisher.address = base::StringPrintf("address%zu", i);
+    list.push_back(std::move(publisher));
+  }
+  return list;
+}
+
+// Same filter as the one used for the auto-contribute list
+ledger::ActivityInfoFilterPtr GetActivityFilter() {
+  auto filter = ledger::ActivityInfoFilter::New();
+  filter->order_by.push_back(
+      ledger::ActivityInfoFilterOrderPair::New("ai.percent", false));
+  filter->reconcile_stamp = kReconcileStamp;
+  filter->excluded = ledger::ExcludeFilter::FILTER_ALL_EXCEPT_EXCLUDED;
+  filter->percent = 1;
+  return filter;
+}
+
+std::vector<std::string> GetPublisherIds(
+    const ledger::PublisherInfoList& list) {
+  std::vector<std::string> ids;
+  for (const auto& info : list) {
+    ids.push_back(info->id);
+  }
+  return ids;
+}
+
+}  // namespace
+
+class RewardsDatabaseTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    database_ = std::make_unique<RewardsDatabase>(
+        temp_dir_.GetPath().AppendASCII("publisher_info_db"));
+    mock_ledger_client_ = std::make_unique<ledger::MockLedgerClient>();
+    mock_ledger_impl_ = std::make_unique<bat_ledger::MockLedgerImpl>(
+        mock_ledger_client_.get());
+
+    auto transaction = ledger::DBTransaction::New();
+    transaction->version = 1;
+    transaction->compatible_version = 1;
+    auto initialize = ledger::DBCommand::New();
+    initialize->type = ledger::DBCommand::Type::INITIALIZE;
+    transaction->commands.push_back(std::move(initialize));
+    auto create = ledger::DBCommand::New();
+    create->type = ledger::DBCommand::Type::EXECUTE;
+    create->command =
+        "CREATE TABLE server_publisher_info ("
+        "publisher_key LONGVARCHAR PRIMARY KEY NOT NULL UNIQUE,"
+        "status INTEGER DEFAULT 0 NOT NULL,"
+        "excluded INTEGER DEFAULT 0 NOT NULL,"
+        "address TEXT NOT NULL"
+        ")";
+    transaction->commands.push_back(std::move(create));
+    ASSERT_EQ(RunTransaction(std::move(transaction))->status,
+              ledger::DBCommandResponse::Status::RESPONSE_OK);
+  }
+
+  ledger::DBCommandResponsePtr RunTransaction(
+      ledger::DBTransactionPtr transaction) {
+    auto response = ledger::DBCommandResponse::New();
+    database_->RunTransaction(std::move(transaction), response.get());
+    return response;
+  }
+
+  int GetServerPublisherCount() {
+    auto transaction = ledger::DBTransaction::New();
+    auto command = ledger::DBCommand::New();
+    command->type = ledger::DBCommand::Type::READ;
+    command->command = "SELECT COUNT(*) FROM server_publisher_info";
+    command->record_bindings = {
+        ledger::DBCommand::RecordBindingType::INT_TYPE
+    };
+    transaction->commands.push_back(std::move(command));
+
+    auto response = RunTransaction(std::move(transaction));
+    if (response->status != ledger::DBCommandResponse::Status::RESPONSE_OK) {
+      return -1;
+    }
+    return braveledger_database::GetIntColumn(
+        response->result->get_records()[0].get(), 0);
+  }
+
+  // Inserts |kActivityCount| activities with many equal percents, every
+  // tenth publisher is excluded
+  void InsertActivityInfoList() {
+    auto transaction = ledger::DBTransaction::New();
+    auto create = ledger::DBCommand::New();
+    create->type = ledger::DBCommand::Type::EXECUTE;
+    create->command =
+        "CREATE TABLE publisher_info("
+        "publisher_id LONGVARCHAR PRIMARY KEY NOT NULL UNIQUE,"
+        "excluded INTEGER DEFAULT 0 NOT NULL,"
+        "name TEXT NOT NULL,"
+        "favIcon TEXT NOT NULL,"
+        "url TEXT NOT NULL,"
+        "provider TEXT NOT NULL"
+        ")";
+    transaction->commands.push_back(std::move(create));
+
+    create = ledger::DBCommand::New();
+    create->type = ledger::DBCommand::Type::EXECUTE;
+    create->command =
+        "CREATE TABLE activity_info ("
+        "publisher_id LONGVARCHAR NOT NULL,"
+        "duration INTEGER DEFAULT 0 NOT NULL,"
+        "visits INTEGER DEFAULT 0 NOT NULL,"
+        "score DOUBLE DEFAULT 0 NOT NULL,"
+        "percent INTEGER DEFAULT 0 NOT NULL,"
+        "weight DOUBLE DEFAULT 0 NOT NULL,"
+        "reconcile_stamp INTEGER DEFAULT 0 NOT NULL,"
+        "CONSTRAINT activity_unique "
+        "UNIQUE (publisher_id, reconcile_stamp)"
+        ")";
+    transaction->commands.push_back(std::move(create));
+
+    create = ledger::DBCommand::New();
+    create->type = ledger::DBCommand::Type::EXECUTE;
+    create->command =
+        "CREATE INDEX activity_info_reconcile_stamp_percent_index "
+        "ON activity_info (reconcile_stamp, percent, publisher_id)";
+    transaction->commands.push_back(std::move(create));
+
+    braveledger_database::InsertRows(
+        transaction.get(),
+        "publisher_info",
+        {"publisher_id", "excluded", "name", "favIcon", "url", "provider"},
+        kActivityCount,
+        [](ledger::DBCommand* command, const int index, const size_t row) {
+          const auto excluded = row % 10 == 0
+              ? ledger::PublisherExclude::EXCLUDED
+              : ledger::PublisherExclude::DEFAULT;
+          braveledger_database::BindString(
+              command, index, base::StringPrintf("publisher%zu.com", row));
+          braveledger_database::BindInt(
+              command, index + 1, static_cast<int>(excluded));
+          braveledger_database::BindString(command, index + 2, "name");
+          braveledger_database::BindString(command, index + 3, "");
+          braveledger_database::BindString(command, index + 4, "url");
+          braveledger_database::BindString(command, index + 5, "");
+        });
+
+    braveledger_database::InsertRows(
+        transaction.get(),
+        "activity_info",
+        {"publisher_id", "duration", "visits", "score", "percent", "weight",
+         "reconcile_stamp"},
+        kActivityCount,
+        [](ledger::DBCommand* command, const int index, const size_t row) {
+          braveledger_database::BindString(
+              command, index, base::StringPrintf("publisher%zu.com", row));
+          braveledger_database::BindInt64(command, index + 1, 10);
+          braveledger_database::BindInt(command, index + 2, 1);
+          braveledger_database::BindDouble(command, index + 3, 1.0);
+          braveledger_database::BindInt64(command, index + 4, row % 100 + 1);
+          braveledger_database::BindDouble(command, index + 5, 1.0);
+          braveledger_database::BindInt64(command, index + 6, kReconcileStamp);
+        });
+
+    ASSERT_EQ(RunTransaction(std::move(transaction))->status,
+              ledger::DBCommandResponse::Status::RESPONSE_OK);
+  }
+
+  void CreateServerPublisherBannerTables() {
+    auto transaction = ledger::DBTransaction::New();
+    auto create = ledger::DBCommand::New();
+    create->type = ledger::DBCommand::Type::EXECUTE;
+    create->command =
+        "CREATE TABLE server_publisher_banner ("
+        "publisher_key LONGVARCHAR PRIMARY KEY NOT NULL UNIQUE,"
+        "title TEXT,"
+        "description TEXT,"
+        "background TEXT,"
+        "logo TEXT"
+        ")";
+    transaction->commands.push_back(std::move(create));
+
+    create = ledger::DBCommand::New();
+    create->type = ledger::DBCommand::Type::EXECUTE;
+    create->command =
+        "CREATE TABLE server_publisher_links ("
+        "publisher_key LONGVARCHAR NOT NULL,"
+        "provider TEXT,"
+        "link TEXT,"
+        "CONSTRAINT server_publisher_links_unique "
+        "UNIQUE (publisher_key, provider)"
+        ")";
+    transaction->commands.push_back(std::move(create));
+
+    create = ledger::DBCommand::New();
+    create->type = ledger::DBCommand::Type::EXECUTE;
+    create->command =
+        "CREATE TABLE server_publisher_amounts ("
+        "publisher_key LONGVARCHAR NOT NULL,"
+        "amount DOUBLE DEFAULT 0 NOT NULL,"
+        "CONSTRAINT server_publisher_amounts_unique "
+        "UNIQUE (publisher_key, amount)"
+        ")";
+    transaction->commands.push_back(std::move(create));
+
+    ASSERT_EQ(RunTransaction(std::move(transaction))->status,
+              ledger::DBCommandResponse::Status::RESPONSE_OK);
+  }
+
+  // Inserts |kUnblindedTokenCount| tokens, every fifth one is expired
+  void InsertUnblindedTokenList() {
+    auto transaction = ledger::DBTransaction::New();
+    auto create = ledger::DBCommand::New();
+    create->type = ledger::DBCommand::Type::EXECUTE;
+    create->command =
+        "CREATE TABLE unblinded_tokens ("
+        "token_id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL,"
+        "token_value TEXT,"
+        "public_key TEXT,"
+        "value DOUBLE NOT NULL DEFAULT 0,"
+        "creds_id TEXT,"
+        "expires_at TIMESTAMP NOT NULL DEFAULT 0,"
+        "created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP"
+        ")";
+    transaction->commands.push_back(std::move(create));
+
+    braveledger_database::InsertRows(
+        transaction.get(),
+        "unblinded_tokens",
+        {"token_value", "public_key", "value", "creds_id", "expires_at"},
+        kUnblindedTokenCount,
+        [](ledger::DBCommand* command, const int index, const size_t row) {
+          braveledger_database::BindString(
+              command, index, base::StringPrintf("token%zu", row));
+          braveledger_database::BindString(command, index + 1, "public_key");
+          braveledger_database::BindDouble(
+              command, index + 2, kUnblindedTokenValue);
+          braveledger_database::BindString(command, index + 3, "creds_id");
+          braveledger_database::BindInt64(
+              command, index + 4, row % 5 == 0 ? 1 : 0);
+        });
+
+    ASSERT_EQ(RunTransaction(std::move(transaction))->status,
+              ledger::DBCommandResponse::Status::RESPONSE_OK);
+  }
+
+  int GetUnblindedTokenCount() {
+    auto transaction = ledger::DBTransaction::New();
+    auto command = ledger::DBCommand::New();
+    command->type = ledger::DBCommand::Type::READ;
+    command->command = "SELECT COUNT(*) FROM unblinded_tokens";
+    command->record_bindings = {
+        ledger::DBCommand::RecordBindingType::INT_TYPE
+    };
+    transaction->commands.push_back(std::move(command));
+
+    auto response = RunTransaction(std::move(transaction));
+    if (response->status != ledger::DBCommandResponse::Status::RESPONSE_OK) {
+      return -1;
+    }
+    return braveledger_database::GetIntColumn(
+        response->result->get_records()[0].get(), 0);
+  }
+
+  // Ledger transactions are run synchronously against |database_|, rows
+  // returned by reads are counted in |read_rows_|
+  void ForwardTransactionsToDatabase() {
+    EXPECT_CALL(*mock_ledger_impl_, RunDBTransaction(_, _))
+        .Times(AnyNumber())
+        .WillRepeatedly(
+          Invoke([&](
+              ledger::DBTransactionPtr transaction,
+              ledger::RunDBTransactionCallback callback) {
+            auto response = RunTransaction(std::move(transaction));
+            if (response->result && response->result->is_records()) {
+              read_rows_ += response->result->get_records().size();
+            }
+            callback(std::move(response));
+          }));
+  }
+
+  ledger::PublisherInfoList GetActivityPage(
+      const int start,
+      ledger::ActivityInfoFilterPtr filter) {
+    braveledger_database::DatabaseActivityInfo activity_info(
+        mock_ledger_impl_.get());
+    ledger::PublisherInfoList page;
+    activity_info.GetRecordsList(
+        start,
+        kActivityPageSize,
+        std::move(filter),
+        [&page](ledger::PublisherInfoList list) {
+          page = std::move(list);
+        });
+    return page;
+  }
+
+  // Filter for the page following |page|
+  ledger::ActivityInfoFilterPtr GetActivityFilterAfter(
+      const ledger::PublisherInfoList& page) {
+    auto filter = GetActivityFilter();
+    const auto& last = page.back();
+    filter->after = ledger::ActivityInfoFilterCursor::New(
+        static_cast<double>(last->percent),
+        last->id);
+    return filter;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<RewardsDatabase> database_;
+  std::unique_ptr<ledger::MockLedgerClient> mock_ledger_client_;
+  std::unique_ptr<bat_ledger::MockLedgerImpl> mock_ledger_impl_;
+  size_t read_rows_ = 0;
+};
+
+TEST_F(RewardsDatabaseTest, InsertServerPublisherList) {
+  // Two full statements and a partial one.
+  const size_t max_rows = braveledger_database::GetMaxRowsPerInsert(4);
+  const size_t count = 2 * max_rows + 3;
+
+  size_t command_count = 0;
+  EXPECT_CALL(*mock_ledger_impl_, RunDBTransaction(_, _))
+      .WillOnce(
+        Invoke([&](
+            ledger::DBTransactionPtr transaction,
+            ledger::RunDBTransactionCallback callback) {
+          command_count = transaction->commands.size();
+          callback(RunTransaction(std::move(transaction)));
+        }));
+
+  braveledger_database::DatabaseServerPublisherInfo server_publisher_info(
+      mock_ledger_impl_.get());
+  ledger::Result result = ledger::Result::LEDGER_ERROR;
+  server_publisher_info.InsertOrUpdatePartialList(
+      GetServerPublisherList(count),
+      [&result](const ledger::Result callback_result) {
+        result = callback_result;
+      });
+
+  EXPECT_EQ(result, ledger::Result::LEDGER_OK);
+  EXPECT_EQ(command_count, 3u);
+  EXPECT_EQ(GetServerPublisherCount(), static_cast<int>(count));
+
+  // Every row is bound to its own values, including those of the last,
+  // partial statement.
+  auto transaction = ledger::DBTransaction::New();
+  auto command = ledger::DBCommand::New();
+  command->type = ledger::DBCommand::Type::READ;
+  command->command =
+      "SELECT COUNT(*) FROM server_publisher_info "
+      "WHERE address = 'address' || "
+      "substr(publisher_key, 10, length(publisher_key) - 13) "
+      "AND status = ? AND excluded = 0";
+  braveledger_database::BindInt(
+      command.get(), 0, static_cast<int>(ledger::PublisherStatus::VERIFIED));
+  command->record_bindings = {
+      ledger::DBCommand::RecordBindingType::INT_TYPE
+  };
+  transaction->commands.push_back(std::move(command));
+  auto response = RunTransaction(std::move(transaction));
+  ASSERT_EQ(response->status, ledger::DBCommandResponse::Status::RESPONSE_OK);
+  EXPECT_EQ(braveledger_database::GetIntColumn(
+      response->result->get_records()[0].get(), 0), static_cast<int>(count));
+}
+
+// Compares inserting server publishers with batched statements to one
+// statement per row, as it was done before. Disabled as it takes a while,
+// run it with --gtest_also_run_disabled_tests.
+TEST_F(RewardsDatabaseTest, DISABLED_InsertServerPublisherListBenchmark) {
+  const auto list = GetServerPublisherList(kPublisherCount);
+
+  // One statement per row.
+  auto transaction = ledger::DBTransaction::New();
+  for (const auto& info : list) {
+    auto command = ledger::DBCommand::New();
+    command->type = ledger::DBCommand::Type::RUN;
+    command->command =
+        "INSERT OR REPLACE INTO server_publisher_info "
+        "(publisher_key, status, excluded, address) VALUES (?, ?, ?, ?)";
+    braveledger_database::BindString(command.get(), 0, info.publisher_key);
+    braveledger_database::BindInt(
+        command.get(), 1, static_cast<int>(info.status));
+    braveledger_database::BindBool(command.get(), 2, info.excluded);
+    braveledger_database::BindString(command.get(), 3, info.address);
+    transaction->commands.push_back(std::move(command));
+  }
+
+  base::ElapsedTimer per_row_timer;
+  ASSERT_EQ(RunTransaction(std::move(transaction))->status,
+            ledger::DBCommandResponse::Status::RESPONSE_OK);
+  const base::TimeDelta per_row_time = per_row_timer.Elapsed();
+  EXPECT_EQ(GetServerPublisherCount(), static_cast<int>(kPublisherCount));
+
+  // Batched statements, replacing the rows inserted above.
+  size_t command_count = 0;
+  EXPECT_CALL(*mock_ledger_impl_, RunDBTransaction(_, _))
+      .WillOnce(
+        Invoke([&](
+            ledger::DBTransactionPtr transaction,
+            ledger::RunDBTransactionCallback callback) {
+          command_count = transaction->commands.size();
+          callback(RunTransaction(std::move(transaction)));
+        }));
+
+  braveledger_database::DatabaseServerPublisherInfo server_publisher_info(
+      mock_ledger_impl_.get());
+  ledger::Result result = ledger::Result::LEDGER_ERROR;
+  base::ElapsedTimer batched_timer;
+  server_publisher_info.InsertOrUpdatePartialList(
+      list,
+      [&result](const ledger::Result callback_result) {
+        result = callback_result;
+      });
+  const base::TimeDelta batched_time = batched_timer.Elapsed();
+
+  EXPECT_EQ(result, ledger::Result::LEDGER_OK);
+  EXPECT_EQ(GetServerPublisherCount(), static_cast<int>(kPublisherCount));
+  const size_t max_rows = braveledger_database::GetMaxRowsPerInsert(4);
+  EXPECT_EQ(command_count, (kPublisherCount + max_rows - 1) / max_rows);
+
+  LOG(INFO) << "Inserting " << kPublisherCount << " server publishers took "
+            << per_row_time.InMilliseconds() << "ms with one statement per "
+            << "row and " << batched_time.InMilliseconds() << "ms batched";
+}
+
+TEST_F(RewardsDatabaseTest, ActivityInfoKeysetPagesMatchOffsetPages) {
+  InsertActivityInfoList();
+  ForwardTransactionsToDatabase();
+
+  std::vector<std::string> offset_ids;
+  for (int start = 0; ; start += kActivityPageSize) {
+    const auto page = GetActivityPage(start, GetActivityFilter());
+    const auto ids = GetPublisherIds(page);
+    offset_ids.insert(offset_ids.end(), ids.begin(), ids.end());
+    if (page.size() < static_cast<size_t>(kActivityPageSize)) {
+      break;
+    }
+  }
+
+  std::vector<std::string> keyset_ids;
+  auto page = GetActivityPage(0, GetActivityFilter());
+  while (!page.empty()) {
+    const auto ids = GetPublisherIds(page);
+    keyset_ids.insert(keyset_ids.end(), ids.begin(), ids.end());
+    page = GetActivityPage(0, GetActivityFilterAfter(page));
+  }
+
+  EXPECT_EQ(offset_ids.size(), kActivityCount - kActivityCount / 10);
+  EXPECT_EQ(keyset_ids, offset_ids);
+}
+
+// Compares reading the last page with OFFSET to reading it with a cursor.
+// Disabled as it takes a while, run it with --gtest_also_run_disabled_tests.
+TEST_F(RewardsDatabaseTest, DISABLED_ActivityInfoLastPageBenchmark) {
+  InsertActivityInfoList();
+  ForwardTransactionsToDatabase();
+
+  const int last_start = static_cast<int>(
+      kActivityCount - kActivityCount / 10) - kActivityPageSize;
+  const auto previous_page =
+      GetActivityPage(last_start - kActivityPageSize, GetActivityFilter());
+  ASSERT_EQ(previous_page.size(), static_cast<size_t>(kActivityPageSize));
+
+  base::ElapsedTimer offset_timer;
+  const auto offset_page = GetActivityPage(last_start, GetActivityFilter());
+  const base::TimeDelta offset_time = offset_timer.Elapsed();
+
+  base::ElapsedTimer keyset_timer;
+  const auto keyset_page =
+      GetActivityPage(0, GetActivityFilterAfter(previous_page));
+  const base::TimeDelta keyset_time = keyset_timer.Elapsed();
+
+  EXPECT_EQ(offset_page.size(), static_cast<size_t>(kActivityPageSize));
+  EXPECT_EQ(GetPublisherIds(keyset_page), GetPublisherIds(offset_page));
+
+  LOG(INFO) << "Reading the last page of " << kActivityCount
+            << " activities took " << offset_time.InMilliseconds()
+            << "ms with OFFSET and " << keyset_time.InMilliseconds()
+            << "ms with a cursor";
+}
+
+// Compares the joined server publisher read to reading the record, banner,
+// links and amounts one after another.
+TEST_F(RewardsDatabaseTest, GetServerPublisherRecordMatchesChainedReads) {
+  CreateServerPublisherBannerTables();
+  ForwardTransactionsToDatabase();
+
+  braveledger_database::DatabaseServerPublisherInfo server_publisher_info(
+      mock_ledger_impl_.get());
+
+  std::vector<ledger::ServerPublisherPartial> list;
+  for (const auto* key : {"brave.com", "basicattentiontoken.org"}) {
+    ledger::ServerPublisherPartial publisher;
+    publisher.publisher_key = key;
+    publisher.status = ledger::PublisherStatus::VERIFIED;
+    publisher.excluded = false;
+    publisher.address = "address";
+    list.push_back(std::move(publisher));
+  }
+  server_publisher_info.InsertOrUpdatePartialList(
+      list,
+      [](const ledger::Result result) {
+        EXPECT_EQ(result, ledger::Result::LEDGER_OK);
+      });
+
+  ledger::PublisherBanner banner;
+  banner.publisher_key = "brave.com";
+  banner.title = "title";
+  banner.description = "description";
+  banner.background = "background";
+  banner.logo = "logo";
+  banner.amounts = {1.0, 5.0, 10.0};
+  banner.links = {
+      {"twitter", "https://twitter.com/brave"},
+      {"youtube", "https://www.youtube.com/bravesoftware"}
+  };
+  server_publisher_info.InsertOrUpdateBannerList(
+      {banner},
+      [](const ledger::Result result) {
+        EXPECT_EQ(result, ledger::Result::LEDGER_OK);
+      });
+
+  braveledger_database::DatabaseServerPublisherBanner banner_table(
+      mock_ledger_impl_.get());
+  for (const auto& publisher : list) {
+    ledger::ServerPublisherInfoPtr info;
+    server_publisher_info.GetRecord(
+        publisher.publisher_key,
+        [&info](ledger::ServerPublisherInfoPtr record) {
+          info = std::move(record);
+        });
+    ASSERT_TRUE(info);
+
+    ledger::PublisherBannerPtr chained_banner;
+    banner_table.GetRecord(
+        publisher.publisher_key,
+        [&chained_banner](ledger::PublisherBannerPtr record) {
+          chained_banner = std::move(record);
+        });
+    if (!chained_banner) {
+      chained_banner = ledger::PublisherBanner::New();
+    }
+
+    EXPECT_EQ(info->status, publisher.status);
+    EXPECT_EQ(info->excluded, publisher.excluded);
+    EXPECT_EQ(info->address, publisher.address);
+    EXPECT_TRUE(info->banner.Equals(chained_banner));
+  }
+
+  ledger::ServerPublisherInfoPtr missing_info;
+  server_publisher_info.GetRecord(
+      "unknown.com",
+      [&missing_info](ledger::ServerPublisherInfoPtr record) {
+        missing_info = std::move(record);
+      });
+  EXPECT_FALSE(missing_info);
+}
+
+// Compares rows read when selecting tokens for a contribution in SQL to
+// loading all tokens, as it was done before.
+TEST_F(RewardsDatabaseTest, GetSpendableUnblindedTokensReadsFewRows) {
+  InsertUnblindedTokenList();
+  ForwardTransactionsToDatabase();
+
+  braveledger_database::DatabaseUnblindedToken unblinded_token(
+      mock_ledger_impl_.get());
+
+  read_rows_ = 0;
+  unblinded_token.GetAllRecords([](ledger::UnblindedTokenList list) {});
+  const size_t all_rows = read_rows_;
+
+  const double amount = 5.0;
+  ledger::UnblindedTokenList tokens;
+  read_rows_ = 0;
+  unblinded_token.GetSpendableRecords(
+      amount,
+      [&tokens](ledger::UnblindedTokenList list) {
+        tokens = std::move(list);
+      });
+  const size_t spendable_rows = read_rows_;
+
+  double total = 0.0;
+  for (const auto& token : tokens) {
+    EXPECT_EQ(token->expires_at, 0u);
+    total += token->value;
+  }
+  EXPECT_GE(total, amount);
+  EXPECT_EQ(tokens.size(),
+      static_cast<size_t>(amount / kUnblindedTokenValue));
+
+  EXPECT_EQ(all_rows, kUnblindedTokenCount);
+  EXPECT_LT(spendable_rows, kUnblindedTokenCount / 100);
+  EXPECT_EQ(GetUnblindedTokenCount(),
+      static_cast<int>(kUnblindedTokenCount - kUnblindedTokenCount / 5));
+
+  LOG(INFO) << "Selecting tokens for " << amount << " BAT read "
+            << spendable_rows << " rows, loading all tokens read "
+            << all_rows << " rows";
+}
+
+TEST_F(RewardsDatabaseTest, GetSpendableUnblindedTokensNotEnoughFunds) {
+  InsertUnblindedTokenList();
+  ForwardTransactionsToDatabase();
+
+  braveledger_database::DatabaseUnblindedToken unblinded_token(
+      mock_ledger_impl_.get());
+
+  ledger::UnblindedTokenList tokens;
+  unblinded_token.GetSpendableRecords(
+      kUnblindedTokenCount * kUnblindedTokenValue,
+      [&tokens](ledger::UnblindedTokenList list) {
+        tokens = std::move(list);
+      });
+
+  EXPECT_EQ(tokens.size(), kUnblindedTokenCount - kUnblindedTokenCount / 5);
+}
+
+// More ids than SQLite allows bound in a single statement
+TEST_F(RewardsDatabaseTest, DeleteUnblindedTokensInBatches) {
+  InsertUnblindedTokenList();
+  ForwardTransactionsToDatabase();
+
+  braveledger_database::DatabaseUnblindedToken unblinded_token(
+      mock_ledger_impl_.get());
+
+  std::vector<std::string> ids;
+  for (size_t i = 1; i <= 2500; i++) {
+    ids.push_back(std::to_string(i));
+  }
+
+  ledger::Result result = ledger::Result::LEDGER_ERROR;
+  unblinded_token.DeleteRecordList(
+      ids,
+      [&result](const ledger::Result delete_result) {
+        result = delete_result;
+      });
+
+  EXPECT_EQ(result, ledger::Result::LEDGER_OK);
+  EXPECT_EQ(GetUnblindedTokenCount(),
+      static_cast<int>(kUnblindedTokenCount - ids.size()));
+}
+
+TEST_F(RewardsDatabaseTest, DeleteUnblindedTokensSkipsInvalidIds) {
+  InsertUnblindedTokenList();
+  ForwardTransactionsToDatabase();
+
+  braveledger_database::DatabaseUnblindedToken unblinded_token(
+      mock_ledger_impl_.get());
+
+  ledger::Result result = ledger::Result::LEDGER_ERROR;
+  unblinded_token.DeleteRecordList(
+      {"1", "token", "2"},
+      [&result](const ledger::Result delete_result) {
+        result = delete_result;
+      });
+
+  EXPECT_EQ(result, ledger::Result::LEDGER_OK);
+  EXPECT_EQ(GetUnblindedTokenCount(),
+      static_cast<int>(kUnblindedTokenCount - 2));
+
+  // Nothing is deleted when no id is valid.
+  result = ledger::Result::LEDGER_OK;
+  unblinded_token.DeleteRecordList(
+      {"token"},
+      [&result](const ledger::Result delete_result) {
+        result = delete_result;
+      });
+
+  EXPECT_EQ(result, ledger::Result::LEDGER_ERROR);
+  EXPECT_EQ(GetUnblindedTokenCount(),
+      static_cast<int>(kUnblindedTokenCount - 2));
+}
+
+}  // namespace brave_rewards
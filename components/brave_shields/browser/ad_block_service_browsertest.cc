@@ -4,6 +4,7 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "base/path_service.h"
+#include "base/run_loop.h"
 #include "base/task/post_task.h"
 #include "base/test/thread_test_helper.h"
 #include "brave/browser/brave_browser_process_impl.h"
@@ -14,12 +15,14 @@
 #include "brave/components/brave_shields/browser/ad_block_regional_service.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
+#include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/components/brave_shields/common/features.h"
 #include "brave/vendor/adblock_rust_ffi/src/wrapper.hpp"
 #include "chrome/browser/extensions/extension_browsertest.h"
 #include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
 #include "chrome/common/chrome_features.h"
 #include "chrome/test/base/ui_test_utils.h"
 #include "components/prefs/pref_service.h"
@@ -117,6 +120,20 @@ class AdBlockServiceTest : public ExtensionBrowserTest {
     ASSERT_TRUE(embedded_test_server()->Start());
   }
 
+  // Blocked resources are counted in memory and flushed to prefs
+  // periodically, so flush every tab before reading the counter.
+  uint64_t GetAdsBlockedCount() {
+    TabStripModel* tab_strip = browser()->tab_strip_model();
+    for (int i = 0; i < tab_strip->count(); ++i) {
+      brave_shields::BraveShieldsWebContentsObserver* observer =
+          brave_shields::BraveShieldsWebContentsObserver::FromWebContents(
+              tab_strip->GetWebContentsAt(i));
+      if (observer)
+        observer->FlushBlockedEvents();
+    }
+    return browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked);
+  }
+
   void GetTestDataDir(base::FilePath* test_data_dir) {
     base::ScopedAllowBlockingForTesting allow_blocking;
     base::PathService::Get(brave::DIR_TEST_DATA, test_data_dir);
@@ -215,9 +232,10 @@ class AdBlockServiceTest : public ExtensionBrowserTest {
   }
 
   void WaitForAdBlockServiceThreads() {
-    scoped_refptr<base::ThreadTestHelper> tr_helper(new base::ThreadTestHelper(
-        g_brave_browser_process->local_data_files_service()->GetTaskRunner()));
-    ASSERT_TRUE(tr_helper->Run());
+    base::RunLoop run_loop;
+    g_brave_browser_process->local_data_files_service()->RunWhenReady(
+        run_loop.QuitClosure());
+    run_loop.Run();
     scoped_refptr<base::ThreadTestHelper> io_helper(new base::ThreadTestHelper(
         base::CreateSingleThreadTaskRunner({BrowserThread::IO}).get()));
     ASSERT_TRUE(io_helper->Run());
@@ -239,7 +257,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, AdsGetBlockedByDefaultBlocker) {
       kDefaultAdBlockComponentTestId,
       kDefaultAdBlockComponentTestBase64PublicKey);
   ASSERT_TRUE(InstallDefaultAdBlockExtension());
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
   ui_test_utils::NavigateToURL(browser(), url);
@@ -252,7 +270,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, AdsGetBlockedByDefaultBlocker) {
                                           "addImage('ad_banner.png')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 // Load a page with an image which is not an ad, and make sure it is NOT
@@ -262,7 +280,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
   ASSERT_TRUE(g_brave_browser_process->ad_block_custom_filters_service()
                   ->UpdateCustomFilters("*ad_banner.png"));
 
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
   ui_test_utils::NavigateToURL(browser(), url);
@@ -275,13 +293,13 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
                                           "addImage('logo.png')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 }
 
 // Load a page with an ad image, and make sure it is blocked by custom
 // filters.
 IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, AdsGetBlockedByCustomBlocker) {
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
   ASSERT_TRUE(g_brave_browser_process->ad_block_custom_filters_service()
                   ->UpdateCustomFilters("*ad_banner.png"));
 
@@ -296,7 +314,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, AdsGetBlockedByCustomBlocker) {
                                           "addImage('ad_banner.png')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 // Load a page with an image which is not an ad, and make sure it is NOT
@@ -307,7 +325,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
       kDefaultAdBlockComponentTestId,
       kDefaultAdBlockComponentTestBase64PublicKey);
   ASSERT_TRUE(InstallDefaultAdBlockExtension());
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
   ui_test_utils::NavigateToURL(browser(), url);
@@ -320,7 +338,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
                                           "addImage('logo.png')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 }
 
 // Load a page with an ad image, and make sure it is blocked by the
@@ -329,7 +347,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, AdsGetBlockedByRegionalBlocker) {
   g_browser_process->SetApplicationLocale("fr");
   ASSERT_STREQ(g_browser_process->GetApplicationLocale().c_str(), "fr");
 
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   SetRegionalComponentIdAndBase64PublicKeyForTest(
       kRegionalAdBlockComponentTestId,
@@ -348,7 +366,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, AdsGetBlockedByRegionalBlocker) {
                                           "addImage('ad_fr.png')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 // Load a page with an image which is not an ad, and make sure it is
@@ -358,7 +376,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
   g_browser_process->SetApplicationLocale("fr");
   ASSERT_STREQ(g_browser_process->GetApplicationLocale().c_str(), "fr");
 
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   SetRegionalComponentIdAndBase64PublicKeyForTest(
       kRegionalAdBlockComponentTestId,
@@ -377,7 +395,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
                                           "addImage('logo.png')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 }
 
 // Upgrade from v3 to v4 format data file and make sure v4-specific ad
@@ -396,7 +414,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
   // expect an upgrade install
   ASSERT_TRUE(InstallDefaultAdBlockExtension("adblock-v4", 0));
 
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
   ui_test_utils::NavigateToURL(browser(), url);
@@ -409,7 +427,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
                                           "addImage('v4_specific_banner.png')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 // Load a page with several of the same adblocked xhr requests, it should only
@@ -419,7 +437,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, TwoSameAdsGetCountedAsOne) {
       kDefaultAdBlockComponentTestId,
       kDefaultAdBlockComponentTestBase64PublicKey);
   ASSERT_TRUE(InstallDefaultAdBlockExtension());
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
   ui_test_utils::NavigateToURL(browser(), url);
@@ -434,7 +452,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, TwoSameAdsGetCountedAsOne) {
                                           "xhr('adbanner.js')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 // Load a page with different adblocked xhr requests, it should count each.
@@ -443,7 +461,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, TwoDiffAdsGetCountedAsTwo) {
       kDefaultAdBlockComponentTestId,
       kDefaultAdBlockComponentTestBase64PublicKey);
   ASSERT_TRUE(InstallDefaultAdBlockExtension());
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
   ui_test_utils::NavigateToURL(browser(), url);
@@ -458,7 +476,44 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, TwoDiffAdsGetCountedAsTwo) {
                                           "xhr('adbanner.js?2')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 2ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 2ULL);
+}
+
+// Load a page blocking many different resources in quick succession; the
+// batched counters must still count each of them exactly once.
+IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, ManyAdsGetCountedExactly) {
+  SetDefaultComponentIdAndBase64PublicKeyForTest(
+      kDefaultAdBlockComponentTestId,
+      kDefaultAdBlockComponentTestBase64PublicKey);
+  ASSERT_TRUE(InstallDefaultAdBlockExtension());
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
+
+  GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
+  ui_test_utils::NavigateToURL(browser(), url);
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetActiveWebContents();
+
+  bool as_expected = false;
+  ASSERT_TRUE(ExecuteScriptAndExtractBool(
+      contents,
+      "setExpectations(0, 0, 0, 0, 200, 0);"
+      "for (let i = 0; i < 100; i++) {"
+      "  xhr('adbanner.js?' + i);"
+      "  xhr('adbanner.js?' + i);"
+      "}",
+      &as_expected));
+  EXPECT_TRUE(as_expected);
+  EXPECT_EQ(GetAdsBlockedCount(), 100ULL);
+
+  // Counters pending for a page are flushed when navigating away.
+  ASSERT_TRUE(ExecuteScriptAndExtractBool(contents,
+                                          "setExpectations(0, 0, 0, 0, 201, 0);"
+                                          "xhr('adbanner.js?last')",
+                                          &as_expected));
+  EXPECT_TRUE(as_expected);
+  ui_test_utils::NavigateToURL(browser(),
+                               embedded_test_server()->GetURL("/simple.html"));
+  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 101ULL);
 }
 
 // New tab continues to count blocking the same resource
@@ -467,7 +522,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, NewTabContinuesToBlock) {
       kDefaultAdBlockComponentTestId,
       kDefaultAdBlockComponentTestBase64PublicKey);
   ASSERT_TRUE(InstallDefaultAdBlockExtension());
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   GURL url = embedded_test_server()->GetURL(kAdBlockTestPage);
   ui_test_utils::NavigateToURL(browser(), url);
@@ -480,7 +535,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, NewTabContinuesToBlock) {
                                           "xhr('adbanner.js');",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 
   ui_test_utils::NavigateToURL(browser(), url);
   contents = browser()->tab_strip_model()->GetActiveWebContents();
@@ -491,7 +546,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, NewTabContinuesToBlock) {
                                           "xhr('adbanner.js');",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 2ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 2ULL);
 
   ui_test_utils::NavigateToURL(browser(), url);
 }
@@ -502,7 +557,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, SubFrame) {
       kDefaultAdBlockComponentTestId,
       kDefaultAdBlockComponentTestBase64PublicKey);
   ASSERT_TRUE(InstallDefaultAdBlockExtension());
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   GURL url = embedded_test_server()->GetURL("a.com", "/iframe_blocking.html");
   ui_test_utils::NavigateToURL(browser(), url);
@@ -515,7 +570,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, SubFrame) {
                                           "xhr('adbanner.js?1');",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 
   // Check also an explicit request for a script since it is a common real-world
   // scenario.
@@ -524,7 +579,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, SubFrame) {
                             "s.setAttribute('src', 'adbanner.js?2');"
                             "document.head.appendChild(s);"));
   content::RunAllTasksUntilIdle();
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 2ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 2ULL);
 }
 
 // Load a page with an ad image which is matched on the regional blocker,
@@ -537,7 +592,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
   g_browser_process->SetApplicationLocale("fr");
   ASSERT_STREQ(g_browser_process->GetApplicationLocale().c_str(), "fr");
 
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   SetRegionalComponentIdAndBase64PublicKeyForTest(
       kRegionalAdBlockComponentTestId,
@@ -555,13 +610,13 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
                                           "addImage('ad_fr.png')",
                                           &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 }
 
 // Make sure the third-party flag is passed into the ad-block library properly
 IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, AdBlockThirdPartyWorksByETLDP1) {
   UpdateAdBlockInstanceWithRules("||a.com$third-party");
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   GURL tab_url = embedded_test_server()->GetURL("test.a.com", kAdBlockTestPage);
   GURL resource_url =
@@ -577,14 +632,14 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, AdBlockThirdPartyWorksByETLDP1) {
                          resource_url.spec().c_str()),
       &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 }
 
 // Make sure the third-party flag is passed into the ad-block library properly
 IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
                        AdBlockThirdPartyWorksForThirdPartyHost) {
   UpdateAdBlockInstanceWithRules("||a.com$third-party");
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
   GURL tab_url = embedded_test_server()->GetURL("b.com", kAdBlockTestPage);
   GURL resource_url = embedded_test_server()->GetURL("a.com", "/logo.png");
   ui_test_utils::NavigateToURL(browser(), tab_url);
@@ -598,13 +653,13 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
                          resource_url.spec().c_str()),
       &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 // Load an image from a specific subdomain, and make sure it is blocked.
 IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, BlockNYP) {
   UpdateAdBlockInstanceWithRules("||sp1.nypost.com$third-party");
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
   GURL tab_url = embedded_test_server()->GetURL("b.com", kAdBlockTestPage);
   GURL resource_url =
       embedded_test_server()->GetURL("sp1.nypost.com", "/logo.png");
@@ -619,7 +674,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, BlockNYP) {
                          resource_url.spec().c_str()),
       &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 // Tags for social buttons work
@@ -628,7 +683,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, SocialButttonAdBLockTagTest) {
       base::StringPrintf("||example.com^$tag=%s",
                          brave_shields::kFacebookEmbeds)
           .c_str());
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
   GURL tab_url = embedded_test_server()->GetURL("b.com", kAdBlockTestPage);
   g_brave_browser_process->ad_block_service()->EnableTag(
       brave_shields::kFacebookEmbeds, true);
@@ -646,13 +701,13 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, SocialButttonAdBLockTagTest) {
                          resource_url.spec().c_str()),
       &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 // Lack of tags for social buttons work
 IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, SocialButttonAdBlockDiffTagTest) {
   UpdateAdBlockInstanceWithRules("||example.com^$tag=sup");
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
   GURL tab_url = embedded_test_server()->GetURL("b.com", kAdBlockTestPage);
   g_brave_browser_process->ad_block_service()->EnableTag(
       brave_shields::kFacebookEmbeds, true);
@@ -670,7 +725,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, SocialButttonAdBlockDiffTagTest) {
                          resource_url.spec().c_str()),
       &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 }
 
 // Tags are preserved after resetting
@@ -733,7 +788,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, TagPrefsControlTags) {
 // Make sure that cancelrequest actually blocks
 IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, CancelRequestOptionTest) {
   UpdateAdBlockInstanceWithRules("logo.png$explicitcancel");
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
   GURL tab_url = embedded_test_server()->GetURL("b.com", kAdBlockTestPage);
   GURL resource_url =
       embedded_test_server()->GetURL("example.com", "/logo.png");
@@ -748,7 +803,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, CancelRequestOptionTest) {
                          resource_url.spec().c_str()),
       &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 // Load a page with a script which uses a redirect data URL.
@@ -766,7 +821,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, RedirectRulesAreRespected) {
           "content": "KGZ1bmN0aW9uKCkgewogICAgJ3VzZSBzdHJpY3QnOwp9KSgpOwo="
         }
       ])");
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 0ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 0ULL);
 
   const GURL url = embedded_test_server()->GetURL("example.com",
                                                   kAdBlockTestPage);
@@ -785,7 +840,7 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, RedirectRulesAreRespected) {
                          resource_url.spec().c_str(), noopjs.c_str()),
       &as_expected));
   EXPECT_TRUE(as_expected);
-  EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_EQ(GetAdsBlockedCount(), 1ULL);
 }
 
 class CosmeticFilteringDisabledTest : public AdBlockServiceTest {
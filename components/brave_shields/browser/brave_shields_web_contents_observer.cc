@@ -11,10 +11,15 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
+#include "base/hash/hash.h"
+#include "base/no_destructor.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/pref_names.h"
 #include "brave/common/render_messages.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "brave/components/brave_shields/browser/content_setting_rules_version.h"
+#include "brave/components/brave_shields/browser/sent_content_setting_rules_tracker.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/content/common/frame_messages.h"
 #include "chrome/browser/content_settings/host_content_settings_map_factory.h"
@@ -60,23 +65,46 @@ namespace {
 // the content settings so this is fixed here too. That case is covered in
 // tests by:
 // npm run test -- brave_browser_tests --filter=BraveContentSettingsAgentImplBrowserTest.*  // NOLINT
+// The rules are only built and sent for renderer processes which haven't
+// received them since the content settings last changed; frames sharing a
+// process share its RendererConfiguration.
 void UpdateContentSettingsToRendererFrames(content::WebContents* web_contents) {
+  content::BrowserContext* context = web_contents->GetBrowserContext();
+  std::vector<content::RenderProcessHost*> processes;
   for (content::RenderFrameHost* frame : web_contents->GetAllFrames()) {
-    Profile* profile =
-        Profile::FromBrowserContext(web_contents->GetBrowserContext());
-    const HostContentSettingsMap* map =
-        HostContentSettingsMapFactory::GetForProfile(profile);
-    RendererContentSettingRules rules;
-    GetRendererContentSettingRules(map, &rules);
-    IPC::ChannelProxy* channel =
-        frame->GetProcess()->GetChannel();
+    content::RenderProcessHost* process = frame->GetProcess();
     // channel might be NULL in tests.
-    if (channel) {
-      chrome::mojom::RendererConfigurationAssociatedPtr rc_interface;
-      channel->GetRemoteAssociatedInterface(&rc_interface);
-      rc_interface->SetContentSettingRules(rules);
-    }
+    if (process->GetChannel())
+      processes.push_back(process);
   }
+
+  brave_shields::SentContentSettingRulesTracker::GetInstance()
+      ->SendRulesIfNeeded(
+          HostContentSettingsMapFactory::GetForProfile(context),
+          brave_shields::ContentSettingRulesVersion::Get(context), processes,
+          base::BindRepeating([](content::RenderProcessHost* process,
+                                 const RendererContentSettingRules& rules) {
+            chrome::mojom::RendererConfigurationAssociatedPtr rc_interface;
+            process->GetChannel()->GetRemoteAssociatedInterface(
+                &rc_interface);
+            rc_interface->SetContentSettingRules(rules);
+          }));
+}
+
+constexpr base::TimeDelta kBlockedEventsFlushInterval =
+    base::TimeDelta::FromMilliseconds(250);
+
+// Returns the pref counting blocked resources of |block_type|, or nullptr.
+const char* GetBlockedCountPrefName(const std::string& block_type) {
+  if (block_type == brave_shields::kAds)
+    return kAdsBlocked;
+  if (block_type == brave_shields::kHTTPUpgradableResources)
+    return kHttpsUpgrades;
+  if (block_type == brave_shields::kJavaScript)
+    return kJavascriptBlocked;
+  if (block_type == brave_shields::kFingerprinting)
+    return kFingerprintingBlocked;
+  return nullptr;
 }
 
 WebContents* GetWebContents(
@@ -101,11 +129,19 @@ WebContents* GetWebContents(
 
 namespace brave_shields {
 
-base::Lock BraveShieldsWebContentsObserver::frame_data_map_lock_;
-std::map<BraveShieldsWebContentsObserver::RenderFrameIdKey, GURL>
-    BraveShieldsWebContentsObserver::frame_key_to_tab_url_;
-std::map<int, GURL>
-    BraveShieldsWebContentsObserver::frame_tree_node_id_to_tab_url_;
+// static
+BraveShieldsWebContentsObserver::FrameKeyToTabURLMap&
+BraveShieldsWebContentsObserver::frame_key_to_tab_url() {
+  static base::NoDestructor<FrameKeyToTabURLMap> map;
+  return *map;
+}
+
+// static
+BraveShieldsWebContentsObserver::FrameTreeNodeIdToTabURLMap&
+BraveShieldsWebContentsObserver::frame_tree_node_id_to_tab_url() {
+  static base::NoDestructor<FrameTreeNodeIdToTabURLMap> map;
+  return *map;
+}
 
 BraveShieldsWebContentsObserver::RenderFrameIdKey::RenderFrameIdKey()
     : render_process_id(content::ChildProcessHost::kInvalidUniqueID),
@@ -129,6 +165,11 @@ bool BraveShieldsWebContentsObserver::RenderFrameIdKey::operator==(
          frame_routing_id == other.frame_routing_id;
 }
 
+size_t BraveShieldsWebContentsObserver::RenderFrameIdKeyHash::operator()(
+    const RenderFrameIdKey& key) const {
+  return base::HashInts(key.render_process_id, key.frame_routing_id);
+}
+
 BraveShieldsWebContentsObserver::~BraveShieldsWebContentsObserver() {
 }
 
@@ -148,20 +189,18 @@ void BraveShieldsWebContentsObserver::RenderFrameCreated(
   if (web_contents) {
     UpdateContentSettingsToRendererFrames(web_contents);
 
-    base::AutoLock lock(frame_data_map_lock_);
     const RenderFrameIdKey key(rfh->GetProcess()->GetID(), rfh->GetRoutingID());
-    frame_key_to_tab_url_[key] = web_contents->GetURL();
-    frame_tree_node_id_to_tab_url_[rfh->GetFrameTreeNodeId()] =
-        web_contents->GetURL();
+    frame_key_to_tab_url().Set(key, web_contents->GetURL());
+    frame_tree_node_id_to_tab_url().Set(rfh->GetFrameTreeNodeId(),
+                                        web_contents->GetURL());
   }
 }
 
 void BraveShieldsWebContentsObserver::RenderFrameDeleted(
     RenderFrameHost* rfh) {
-  base::AutoLock lock(frame_data_map_lock_);
   const RenderFrameIdKey key(rfh->GetProcess()->GetID(), rfh->GetRoutingID());
-  frame_key_to_tab_url_.erase(key);
-  frame_tree_node_id_to_tab_url_.erase(rfh->GetFrameTreeNodeId());
+  frame_key_to_tab_url().Erase(key);
+  frame_tree_node_id_to_tab_url().Erase(rfh->GetFrameTreeNodeId());
 }
 
 void BraveShieldsWebContentsObserver::RenderFrameHostChanged(
@@ -184,27 +223,22 @@ void BraveShieldsWebContentsObserver::DidFinishNavigation(
   int routing_id = main_frame->GetRoutingID();
   int tree_node_id = main_frame->GetFrameTreeNodeId();
 
-  base::AutoLock lock(frame_data_map_lock_);
-  frame_key_to_tab_url_[{process_id, routing_id}] = web_contents()->GetURL();
-  frame_tree_node_id_to_tab_url_[tree_node_id] = web_contents()->GetURL();
+  frame_key_to_tab_url().Set({process_id, routing_id},
+                             web_contents()->GetURL());
+  frame_tree_node_id_to_tab_url().Set(tree_node_id, web_contents()->GetURL());
 }
 
 // static
 GURL BraveShieldsWebContentsObserver::GetTabURLFromRenderFrameInfo(
     int render_process_id, int render_frame_id, int render_frame_tree_node_id) {
-  base::AutoLock lock(frame_data_map_lock_);
-  if (-1 != render_process_id && -1 != render_frame_id) {
-    auto iter = frame_key_to_tab_url_.find({render_process_id,
-                                            render_frame_id});
-    if (iter != frame_key_to_tab_url_.end()) {
-      return iter->second;
-    }
+  GURL url;
+  if (-1 != render_process_id && -1 != render_frame_id &&
+      frame_key_to_tab_url().Get({render_process_id, render_frame_id}, &url)) {
+    return url;
   }
-  if (-1 != render_frame_tree_node_id) {
-    auto iter2 = frame_tree_node_id_to_tab_url_.find(render_frame_tree_node_id);
-    if (iter2 != frame_tree_node_id_to_tab_url_.end()) {
-      return iter2->second;
-    }
+  if (-1 != render_frame_tree_node_id &&
+      frame_tree_node_id_to_tab_url().Get(render_frame_tree_node_id, &url)) {
+    return url;
   }
   return GURL();
 }
@@ -230,32 +264,61 @@ void BraveShieldsWebContentsObserver::DispatchBlockedEvent(
 
   WebContents* web_contents = GetWebContents(render_process_id,
     render_frame_id, frame_tree_node_id);
-  DispatchBlockedEventForWebContents(block_type, subresource, web_contents);
+  if (!web_contents)
+    return;
 
-  if (web_contents) {
-    BraveShieldsWebContentsObserver* observer =
-        BraveShieldsWebContentsObserver::FromWebContents(web_contents);
-    if (observer &&
-        !observer->IsBlockedSubresource(subresource)) {
-      observer->AddBlockedSubresource(subresource);
-      PrefService* prefs = Profile::FromBrowserContext(
-          web_contents->GetBrowserContext())->
-          GetOriginalProfile()->
-          GetPrefs();
-
-      if (block_type == kAds) {
-        prefs->SetUint64(kAdsBlocked, prefs->GetUint64(kAdsBlocked) + 1);
-      } else if (block_type == kHTTPUpgradableResources) {
-        prefs->SetUint64(kHttpsUpgrades, prefs->GetUint64(kHttpsUpgrades) + 1);
-      } else if (block_type == kJavaScript) {
-        prefs->SetUint64(kJavascriptBlocked,
-            prefs->GetUint64(kJavascriptBlocked) + 1);
-      } else if (block_type == kFingerprinting) {
-        prefs->SetUint64(kFingerprintingBlocked,
-            prefs->GetUint64(kFingerprintingBlocked) + 1);
-      }
+  BraveShieldsWebContentsObserver* observer =
+      BraveShieldsWebContentsObserver::FromWebContents(web_contents);
+  if (!observer) {
+    DispatchBlockedEventForWebContents(block_type, subresource, web_contents);
+    return;
+  }
+
+  const bool is_new_subresource = !observer->IsBlockedSubresource(subresource);
+  observer->QueueBlockedEvent(block_type, subresource);
+  if (is_new_subresource) {
+    observer->AddBlockedSubresource(subresource);
+    if (const char* pref_name = GetBlockedCountPrefName(block_type))
+      observer->pending_blocked_counts_[pref_name]++;
+  }
+}
+
+void BraveShieldsWebContentsObserver::QueueBlockedEvent(
+    const std::string& block_type,
+    const std::string& subresource) {
+  pending_blocked_events_.push_back({block_type, subresource});
+  if (!flush_blocked_events_timer_.IsRunning()) {
+    flush_blocked_events_timer_.Start(
+        FROM_HERE, kBlockedEventsFlushInterval,
+        base::BindOnce(&BraveShieldsWebContentsObserver::FlushBlockedEvents,
+                       base::Unretained(this)));
+  }
+}
+
+void BraveShieldsWebContentsObserver::FlushBlockedEvents() {
+  flush_blocked_events_timer_.Stop();
+
+  if (!pending_blocked_counts_.empty()) {
+    PrefService* prefs = Profile::FromBrowserContext(
+        web_contents()->GetBrowserContext())->
+        GetOriginalProfile()->
+        GetPrefs();
+    for (const auto& count : pending_blocked_counts_) {
+      prefs->SetUint64(count.first,
+                       prefs->GetUint64(count.first) + count.second);
     }
+    pending_blocked_counts_.clear();
   }
+
+  if (!pending_blocked_events_.empty()) {
+    std::vector<BlockedEvent> events;
+    events.swap(pending_blocked_events_);
+    DispatchBlockedEventsForWebContents(events, web_contents());
+  }
+}
+
+void BraveShieldsWebContentsObserver::WebContentsDestroyed() {
+  FlushBlockedEvents();
 }
 
 #if !defined(OS_ANDROID)
@@ -286,6 +349,38 @@ void BraveShieldsWebContentsObserver::DispatchBlockedEventForWebContents(
   }
 #endif
 }
+
+// static
+void BraveShieldsWebContentsObserver::DispatchBlockedEventsForWebContents(
+    const std::vector<BlockedEvent>& events,
+    WebContents* web_contents) {
+#if BUILDFLAG(ENABLE_EXTENSIONS)
+  if (!web_contents || events.empty()) {
+    return;
+  }
+  Profile* profile =
+      Profile::FromBrowserContext(web_contents->GetBrowserContext());
+  EventRouter* event_router = EventRouter::Get(profile);
+  if (profile && event_router) {
+    const int tab_id = extensions::ExtensionTabUtil::GetTabId(web_contents);
+    std::vector<extensions::api::brave_shields::OnBlockedBatch::DetailsType>
+        details_list(events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+      details_list[i].tab_id = tab_id;
+      details_list[i].block_type = events[i].block_type;
+      details_list[i].subresource = events[i].subresource;
+    }
+    std::unique_ptr<base::ListValue> args(
+        extensions::api::brave_shields::OnBlockedBatch::Create(details_list)
+          .release());
+    std::unique_ptr<Event> event(
+        new Event(extensions::events::BRAVE_AD_BLOCKED,
+          extensions::api::brave_shields::OnBlockedBatch::kEventName,
+          std::move(args)));
+    event_router->BroadcastEvent(std::move(event));
+  }
+#endif
+}
 #endif
 
 bool BraveShieldsWebContentsObserver::OnMessageReceived(
@@ -310,8 +405,7 @@ void BraveShieldsWebContentsObserver::OnJavaScriptBlockedWithDetail(
   if (!web_contents) {
     return;
   }
-  DispatchBlockedEventForWebContents(brave_shields::kJavaScript,
-      base::UTF16ToUTF8(details), web_contents);
+  QueueBlockedEvent(brave_shields::kJavaScript, base::UTF16ToUTF8(details));
 }
 
 void BraveShieldsWebContentsObserver::OnFingerprintingBlockedWithDetail(
@@ -322,8 +416,8 @@ void BraveShieldsWebContentsObserver::OnFingerprintingBlockedWithDetail(
   if (!web_contents) {
     return;
   }
-  DispatchBlockedEventForWebContents(brave_shields::kFingerprinting,
-      base::UTF16ToUTF8(details), web_contents);
+  QueueBlockedEvent(brave_shields::kFingerprinting,
+                    base::UTF16ToUTF8(details));
 }
 
 // static
@@ -342,6 +436,8 @@ void BraveShieldsWebContentsObserver::ReadyToCommitNavigation(
   if (navigation_handle->IsInMainFrame() &&
       !navigation_handle->IsSameDocument() &&
       navigation_handle->GetReloadType() == content::ReloadType::NONE) {
+    // Report what the previous page blocked before its state is reset.
+    FlushBlockedEvents();
     allowed_script_origins_.clear();
     blocked_url_paths_.clear();
   }
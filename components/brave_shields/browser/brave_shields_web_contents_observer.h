@@ -12,8 +12,9 @@
 #include <vector>
 
 #include "base/macros.h"
-#include "base/synchronization/lock.h"
 #include "base/strings/string16.h"
+#include "base/timer/timer.h"
+#include "brave/components/brave_shields/browser/concurrent_frame_url_map.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
 
@@ -32,10 +33,19 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
   ~BraveShieldsWebContentsObserver() override;
 
   static void RegisterProfilePrefs(PrefRegistrySimple* registry);
+  struct BlockedEvent {
+    std::string block_type;
+    std::string subresource;
+  };
+
   static void DispatchBlockedEventForWebContents(
       const std::string& block_type,
       const std::string& subresource,
       content::WebContents* web_contents);
+  // Dispatches several blocked events for |web_contents| at once.
+  static void DispatchBlockedEventsForWebContents(
+      const std::vector<BlockedEvent>& events,
+      content::WebContents* web_contents);
   static void DispatchBlockedEvent(
       std::string block_type,
       std::string subresource,
@@ -49,6 +59,14 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
   bool IsBlockedSubresource(const std::string& subresource);
   void AddBlockedSubresource(const std::string& subresource);
 
+  // Blocked resources are accumulated in memory and flushed to the shields
+  // panel and the blocked counter prefs at most once per
+  // |kBlockedEventsFlushInterval|, so pages blocking hundreds of resources
+  // don't cause hundreds of pref writes and extension events.
+  void QueueBlockedEvent(const std::string& block_type,
+                         const std::string& subresource);
+  void FlushBlockedEvents();
+
  protected:
     // A set of identifiers that uniquely identifies a RenderFrame.
   struct RenderFrameIdKey {
@@ -65,6 +83,14 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
     bool operator==(const RenderFrameIdKey& other) const;
   };
 
+  struct RenderFrameIdKeyHash {
+    size_t operator()(const RenderFrameIdKey& key) const;
+  };
+
+  using FrameKeyToTabURLMap =
+      ConcurrentFrameURLMap<RenderFrameIdKey, RenderFrameIdKeyHash>;
+  using FrameTreeNodeIdToTabURLMap = ConcurrentFrameURLMap<int>;
+
   // content::WebContentsObserver overrides.
   void RenderFrameCreated(content::RenderFrameHost* host) override;
   void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
@@ -74,6 +100,7 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
       content::NavigationHandle* navigation_handle) override;
   void DidFinishNavigation(
       content::NavigationHandle* navigation_handle) override;
+  void WebContentsDestroyed() override;
 
   // Invoked if an IPC message is coming from a specific RenderFrameHost.
   bool OnMessageReceived(const IPC::Message& message,
@@ -85,12 +112,10 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
       content::RenderFrameHost* render_frame_host,
       const base::string16& details);
 
-  // TODO(iefremov): Refactor this away or at least put into base::NoDestructor.
-  // Protects global maps below from being concurrently written on the UI thread
-  // and read on the IO thread.
-  static base::Lock frame_data_map_lock_;
-  static std::map<RenderFrameIdKey, GURL> frame_key_to_tab_url_;
-  static std::map<int, GURL> frame_tree_node_id_to_tab_url_;
+  // Global maps written on the UI thread and read from the network path on
+  // other threads.
+  static FrameKeyToTabURLMap& frame_key_to_tab_url();
+  static FrameTreeNodeIdToTabURLMap& frame_tree_node_id_to_tab_url();
 
  private:
   friend class content::WebContentsUserData<BraveShieldsWebContentsObserver>;
@@ -98,6 +123,10 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
   // We keep a set of the current page's blocked URLs in case the page
   // continually tries to load the same blocked URLs.
   std::set<std::string> blocked_url_paths_;
+  // Blocked events and pref counter increments waiting for the next flush.
+  std::vector<BlockedEvent> pending_blocked_events_;
+  std::map<std::string, uint64_t> pending_blocked_counts_;
+  base::OneShotTimer flush_blocked_events_timer_;
 
   WEB_CONTENTS_USER_DATA_KEY_DECL();
   DISALLOW_COPY_AND_ASSIGN(BraveShieldsWebContentsObserver);
@@ -0,0 +1,85 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_CONCURRENT_FRAME_URL_MAP_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_CONCURRENT_FRAME_URL_MAP_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <functional>
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+// Frame -> tab URL map which is written on the UI thread and read from the
+// network path on other threads. Entries are spread over independently
+// locked shards, so concurrent lookups for different frames almost never
+// wait on each other or on the writer.
+template <typename Key, typename Hash = std::hash<Key>>
+class ConcurrentFrameURLMap {
+ public:
+  ConcurrentFrameURLMap() = default;
+  ~ConcurrentFrameURLMap() = default;
+
+  void Set(const Key& key, const GURL& url) {
+    Shard& shard = GetShard(key);
+    base::AutoLock lock(shard.lock);
+    shard.map[key] = url;
+  }
+
+  void Erase(const Key& key) {
+    Shard& shard = GetShard(key);
+    base::AutoLock lock(shard.lock);
+    shard.map.erase(key);
+  }
+
+  // Copies the URL for |key| into |url| and returns true if present.
+  bool Get(const Key& key, GURL* url) const {
+    const Shard& shard = GetShard(key);
+    base::AutoLock lock(shard.lock);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end())
+      return false;
+    *url = it->second;
+    return true;
+  }
+
+  size_t size() const {
+    size_t result = 0;
+    for (const Shard& shard : shards_) {
+      base::AutoLock lock(shard.lock);
+      result += shard.map.size();
+    }
+    return result;
+  }
+
+ private:
+  static constexpr size_t kShardCount = 16;
+
+  struct Shard {
+    mutable base::Lock lock;
+    std::unordered_map<Key, GURL, Hash> map;
+  };
+
+  Shard& GetShard(const Key& key) {
+    return shards_[Hash()(key) % kShardCount];
+  }
+  const Shard& GetShard(const Key& key) const {
+    return shards_[Hash()(key) % kShardCount];
+  }
+
+  std::array<Shard, kShardCount> shards_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentFrameURLMap);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_CONCURRENT_FRAME_URL_MAP_H_
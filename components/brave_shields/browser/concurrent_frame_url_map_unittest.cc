@@ -0,0 +1,100 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/concurrent_frame_url_map.h"
+
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+using FrameURLMap = brave_shields::ConcurrentFrameURLMap<int>;
+
+constexpr int kStableFrameCount = 100;
+constexpr int kChurnFrameCount = 1000;
+
+GURL GetTabURL(int frame_id) {
+  return GURL("https://tab" + base::NumberToString(frame_id) + ".com/");
+}
+
+// Simulates navigation churn: frames are repeatedly created, navigated and
+// deleted.
+class ChurnDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit ChurnDelegate(FrameURLMap* map) : map_(map) {}
+
+  void Run() override {
+    for (int round = 0; round < 20; ++round) {
+      for (int i = 0; i < kChurnFrameCount; ++i)
+        map_->Set(kStableFrameCount + i, GetTabURL(kStableFrameCount + i));
+      for (int i = 0; i < kChurnFrameCount; ++i)
+        map_->Erase(kStableFrameCount + i);
+    }
+  }
+
+ private:
+  FrameURLMap* map_;
+};
+
+// Simulates the network path looking up tab URLs for requests.
+class LookupDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit LookupDelegate(FrameURLMap* map) : map_(map) {}
+
+  void Run() override {
+    GURL url;
+    for (int round = 0; round < 200; ++round) {
+      for (int i = 0; i < kStableFrameCount; ++i) {
+        // Stable frames are always present and never torn.
+        ASSERT_TRUE(map_->Get(i, &url));
+        ASSERT_EQ(GetTabURL(i), url);
+      }
+      // Churned frames may or may not be present, but are never wrong.
+      const int churned = kStableFrameCount + round % kChurnFrameCount;
+      if (map_->Get(churned, &url))
+        ASSERT_EQ(GetTabURL(churned), url);
+    }
+  }
+
+ private:
+  FrameURLMap* map_;
+};
+
+}  // namespace
+
+TEST(ConcurrentFrameURLMapTest, Basic) {
+  FrameURLMap map;
+  GURL url;
+  EXPECT_FALSE(map.Get(1, &url));
+  map.Set(1, GURL("https://brave.com/"));
+  ASSERT_TRUE(map.Get(1, &url));
+  EXPECT_EQ(GURL("https://brave.com/"), url);
+  map.Set(1, GURL("https://example.com/"));
+  ASSERT_TRUE(map.Get(1, &url));
+  EXPECT_EQ(GURL("https://example.com/"), url);
+  EXPECT_EQ(1u, map.size());
+  map.Erase(1);
+  EXPECT_FALSE(map.Get(1, &url));
+  EXPECT_EQ(0u, map.size());
+}
+
+TEST(ConcurrentFrameURLMapTest, ConcurrentLookupsDuringChurn) {
+  FrameURLMap map;
+  for (int i = 0; i < kStableFrameCount; ++i)
+    map.Set(i, GetTabURL(i));
+
+  // One thread churns frames while the others look up tab URLs.
+  ChurnDelegate churn_delegate(&map);
+  LookupDelegate lookup_delegate(&map);
+  base::DelegateSimpleThreadPool pool("FrameURLMapStress", 9);
+  pool.AddWork(&churn_delegate);
+  pool.AddWork(&lookup_delegate, 8);
+  pool.Start();
+  pool.JoinAll();
+
+  EXPECT_EQ(static_cast<size_t>(kStableFrameCount), map.size());
+}
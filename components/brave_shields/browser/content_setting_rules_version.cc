@@ -0,0 +1,58 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/content_setting_rules_version.h"
+
+#include "base/memory/ptr_util.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
+
+namespace brave_shields {
+
+namespace {
+
+const char kContentSettingRulesVersionKey[] = "content_setting_rules_version";
+
+uint64_t NextVersion() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  static uint64_t next_version = 0;
+  return ++next_version;
+}
+
+}  // namespace
+
+ContentSettingRulesVersion::ContentSettingRulesVersion(
+    HostContentSettingsMap* map)
+    : map_(map), version_(NextVersion()), observer_(this) {
+  observer_.Add(map);
+}
+
+ContentSettingRulesVersion::~ContentSettingRulesVersion() = default;
+
+// static
+uint64_t ContentSettingRulesVersion::Get(content::BrowserContext* context) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto* rules_version = static_cast<ContentSettingRulesVersion*>(
+      context->GetUserData(kContentSettingRulesVersionKey));
+  if (!rules_version) {
+    rules_version = new ContentSettingRulesVersion(
+        HostContentSettingsMapFactory::GetForProfile(context));
+    // Object cleanup is handled by SupportsUserData
+    context->SetUserData(kContentSettingRulesVersionKey,
+                         base::WrapUnique(rules_version));
+  }
+  return rules_version->version_;
+}
+
+void ContentSettingRulesVersion::OnContentSettingChanged(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSettingsType content_type,
+    const std::string& resource_identifier) {
+  version_ = NextVersion();
+}
+
+}  // namespace brave_shields
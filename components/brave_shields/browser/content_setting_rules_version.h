@@ -0,0 +1,59 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_CONTENT_SETTING_RULES_VERSION_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_CONTENT_SETTING_RULES_VERSION_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/scoped_observer.h"
+#include "base/supports_user_data.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+
+namespace content {
+class BrowserContext;
+}  // namespace content
+
+namespace brave_shields {
+
+// Changes whenever a content setting of a browser context changes, so the
+// content setting rules sent to its renderers only have to be rebuilt after
+// a change. Versions are never reused, not even across browser contexts.
+// Only used on the UI thread.
+class ContentSettingRulesVersion : public base::SupportsUserData::Data,
+                                   public content_settings::Observer {
+ public:
+  ~ContentSettingRulesVersion() override;
+
+  // Returns the current version for |context|. Changes are only counted
+  // from the first call on.
+  static uint64_t Get(content::BrowserContext* context);
+
+  // content_settings::Observer overrides:
+  void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
+                               const ContentSettingsPattern& secondary_pattern,
+                               ContentSettingsType content_type,
+                               const std::string& resource_identifier) override;
+
+ private:
+  explicit ContentSettingRulesVersion(HostContentSettingsMap* map);
+
+  // Keeps the map alive until it is no longer observed.
+  scoped_refptr<HostContentSettingsMap> map_;
+  uint64_t version_;
+  ScopedObserver<HostContentSettingsMap, content_settings::Observer>
+      observer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingRulesVersion);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_CONTENT_SETTING_RULES_VERSION_H_
@@ -3,11 +3,50 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/simple_thread.h"
 #include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+// Hammers a shared cache with a mix of adds, gets and removes.
+class CacheStressDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  CacheStressDelegate(HTTPSERecentlyUsedCache<std::string>* cache, int seed)
+      : cache_(cache), seed_(seed) {}
+
+  void Run() override {
+    std::string value;
+    for (int i = 0; i < 10000; ++i) {
+      const std::string key = base::NumberToString((seed_ * 7919 + i) % 500);
+      switch (i % 3) {
+        case 0:
+          cache_->add(key, key);
+          break;
+        case 1:
+          // Values must never be torn or mixed up between keys.
+          if (cache_->get(key, &value))
+            EXPECT_EQ(key, value);
+          break;
+        case 2:
+          cache_->remove(key);
+          break;
+      }
+    }
+  }
+
+ private:
+  HTTPSERecentlyUsedCache<std::string>* cache_;
+  int seed_;
+};
+
+}  // namespace
+
 TEST(HTTPSEverywhereRecentlyUsedCacheTest, Operations) {
   using Cache = HTTPSERecentlyUsedCache<std::string>;
   Cache cache(3);
@@ -28,3 +67,48 @@ TEST(HTTPSEverywhereRecentlyUsedCacheTest, Operations) {
   cache.remove("kD");
   ASSERT_FALSE(cache.get("kD", &v));
 }
+
+TEST(HTTPSEverywhereRecentlyUsedCacheTest, ClearAllShards) {
+  HTTPSERecentlyUsedCache<bool> cache(10, 4);
+  bool v;
+  cache.add("a.com", true);
+  cache.add("b.com", true);
+  EXPECT_TRUE(cache.get("a.com", &v));
+
+  cache.clear();
+  EXPECT_FALSE(cache.get("a.com", &v));
+  EXPECT_FALSE(cache.get("b.com", &v));
+}
+
+TEST(HTTPSEverywhereRecentlyUsedCacheTest, ShardedCapacity) {
+  HTTPSERecentlyUsedCache<std::string> cache(64, 8);
+  for (int i = 0; i < 1000; ++i)
+    cache.add(base::NumberToString(i), "v");
+  std::string v;
+  size_t found = 0;
+  for (int i = 0; i < 1000; ++i) {
+    if (cache.get(base::NumberToString(i), &v))
+      ++found;
+  }
+  // Each of the 8 shards holds at most 8 entries.
+  EXPECT_LE(found, 64u);
+  EXPECT_GT(found, 0u);
+}
+
+TEST(HTTPSEverywhereRecentlyUsedCacheTest, ConcurrentAccess) {
+  HTTPSERecentlyUsedCache<std::string> cache(100, 8);
+  std::vector<std::unique_ptr<CacheStressDelegate>> delegates;
+  base::DelegateSimpleThreadPool pool("HTTPSECacheStress", 8);
+  for (int i = 0; i < 8; ++i) {
+    delegates.push_back(std::make_unique<CacheStressDelegate>(&cache, i));
+    pool.AddWork(delegates.back().get());
+  }
+  pool.Start();
+  pool.JoinAll();
+
+  // The cache is still usable after concurrent access.
+  std::string v;
+  cache.add("key", "value");
+  EXPECT_TRUE(cache.get("key", &v));
+  EXPECT_EQ("value", v);
+}
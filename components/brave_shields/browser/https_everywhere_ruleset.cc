@@ -0,0 +1,218 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_ruleset.h"
+
+#include <string.h>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/logging.h"
+#include "base/threading/scoped_blocking_call.h"
+#include "third_party/leveldatabase/src/include/leveldb/db.h"
+
+namespace brave_shields {
+
+namespace {
+
+const char kMagic[] = "BRHTTPSE";
+constexpr size_t kMagicLength = 8;
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = kMagicLength + 3 * sizeof(uint32_t);
+constexpr size_t kHostEntrySize = 3 * sizeof(uint32_t);
+constexpr size_t kRuleEntrySize = 2 * sizeof(uint32_t);
+
+void AppendUInt32(uint32_t value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+}  // namespace
+
+HTTPSEverywhereRuleset::HTTPSEverywhereRuleset() = default;
+
+HTTPSEverywhereRuleset::~HTTPSEverywhereRuleset() = default;
+
+// static
+std::unique_ptr<HTTPSEverywhereRuleset> HTTPSEverywhereRuleset::Load(
+    const base::FilePath& path) {
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::WILL_BLOCK);
+  std::unique_ptr<HTTPSEverywhereRuleset> ruleset(new HTTPSEverywhereRuleset);
+  if (!ruleset->mapped_file_.Initialize(path)) {
+    LOG(ERROR) << "Failed to map HTTPSE ruleset " << path.value();
+    return nullptr;
+  }
+  base::StringPiece buffer(
+      reinterpret_cast<const char*>(ruleset->mapped_file_.data()),
+      ruleset->mapped_file_.length());
+  if (!ruleset->Initialize(buffer)) {
+    LOG(ERROR) << "Malformed HTTPSE ruleset " << path.value();
+    return nullptr;
+  }
+  return ruleset;
+}
+
+// static
+std::unique_ptr<HTTPSEverywhereRuleset> HTTPSEverywhereRuleset::LoadFromBuffer(
+    base::StringPiece buffer) {
+  std::unique_ptr<HTTPSEverywhereRuleset> ruleset(new HTTPSEverywhereRuleset);
+  if (!ruleset->Initialize(buffer))
+    return nullptr;
+  return ruleset;
+}
+
+// static
+std::string HTTPSEverywhereRuleset::Serialize(
+    const std::map<std::string, std::string>& entries) {
+  // Deduplicate rule strings; many hosts share the same ruleset.
+  std::map<base::StringPiece, uint32_t> rule_ids;
+  std::vector<base::StringPiece> rules;
+  std::vector<uint32_t> host_rule_ids;
+  for (const auto& entry : entries) {
+    auto result = rule_ids.emplace(entry.second, rules.size());
+    if (result.second)
+      rules.push_back(entry.second);
+    host_rule_ids.push_back(result.first->second);
+  }
+
+  std::string strings;
+  std::string hosts;
+  size_t index = 0;
+  for (const auto& entry : entries) {
+    AppendUInt32(strings.size(), &hosts);
+    AppendUInt32(entry.first.size(), &hosts);
+    AppendUInt32(host_rule_ids[index++], &hosts);
+    strings.append(entry.first);
+  }
+  std::string rule_table;
+  for (const auto& rule : rules) {
+    AppendUInt32(strings.size(), &rule_table);
+    AppendUInt32(rule.size(), &rule_table);
+    strings.append(rule.data(), rule.size());
+  }
+  CHECK_LE(strings.size(), std::numeric_limits<uint32_t>::max());
+
+  std::string result(kMagic, kMagicLength);
+  AppendUInt32(kVersion, &result);
+  AppendUInt32(entries.size(), &result);
+  AppendUInt32(rules.size(), &result);
+  result.append(hosts);
+  result.append(rule_table);
+  result.append(strings);
+  return result;
+}
+
+// static
+bool HTTPSEverywhereRuleset::ConvertFromLevelDB(leveldb::DB* db,
+                                                const base::FilePath& path) {
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::WILL_BLOCK);
+  std::map<std::string, std::string> entries;
+  std::unique_ptr<leveldb::Iterator> it(
+      db->NewIterator(leveldb::ReadOptions()));
+  for (it->SeekToFirst(); it->Valid(); it->Next())
+    entries.emplace(it->key().ToString(), it->value().ToString());
+  if (!it->status().ok()) {
+    LOG(ERROR) << "Failed to read HTTPSE leveldb: "
+               << it->status().ToString();
+    return false;
+  }
+
+  // Written atomically so that a crash never leaves a truncated ruleset
+  // which would be picked up on the next start.
+  return base::ImportantFileWriter::WriteFileAtomically(path,
+                                                        Serialize(entries));
+}
+
+bool HTTPSEverywhereRuleset::Initialize(base::StringPiece buffer) {
+  buffer_ = buffer;
+  if (buffer_.size() < kHeaderSize ||
+      buffer_.substr(0, kMagicLength) != base::StringPiece(kMagic,
+                                                           kMagicLength) ||
+      ReadUInt32(kMagicLength) != kVersion) {
+    return false;
+  }
+
+  host_count_ = ReadUInt32(kMagicLength + sizeof(uint32_t));
+  rule_count_ = ReadUInt32(kMagicLength + 2 * sizeof(uint32_t));
+  hosts_offset_ = kHeaderSize;
+  if ((buffer_.size() - hosts_offset_) / kHostEntrySize < host_count_)
+    return false;
+  rules_offset_ = hosts_offset_ + host_count_ * kHostEntrySize;
+  if ((buffer_.size() - rules_offset_) / kRuleEntrySize < rule_count_)
+    return false;
+  strings_offset_ = rules_offset_ + rule_count_ * kRuleEntrySize;
+  const size_t strings_size = buffer_.size() - strings_offset_;
+
+  // Validate every entry once up front so lookups can skip bounds checks.
+  for (size_t i = 0; i < rule_count_; ++i) {
+    const size_t entry = rules_offset_ + i * kRuleEntrySize;
+    const uint32_t offset = ReadUInt32(entry);
+    const uint32_t length = ReadUInt32(entry + sizeof(uint32_t));
+    if (offset > strings_size || length > strings_size - offset)
+      return false;
+  }
+  base::StringPiece previous_key;
+  for (size_t i = 0; i < host_count_; ++i) {
+    const size_t entry = hosts_offset_ + i * kHostEntrySize;
+    const uint32_t offset = ReadUInt32(entry);
+    const uint32_t length = ReadUInt32(entry + sizeof(uint32_t));
+    const uint32_t rule_id = ReadUInt32(entry + 2 * sizeof(uint32_t));
+    if (offset > strings_size || length > strings_size - offset ||
+        rule_id >= rule_count_) {
+      return false;
+    }
+    base::StringPiece key = GetHostKey(i);
+    if (i > 0 && !(previous_key < key))
+      return false;
+    previous_key = key;
+  }
+  return true;
+}
+
+uint32_t HTTPSEverywhereRuleset::ReadUInt32(size_t offset) const {
+  uint32_t value;
+  memcpy(&value, buffer_.data() + offset, sizeof(value));
+  return value;
+}
+
+base::StringPiece HTTPSEverywhereRuleset::GetString(uint32_t offset,
+                                                    uint32_t length) const {
+  return buffer_.substr(strings_offset_ + offset, length);
+}
+
+base::StringPiece HTTPSEverywhereRuleset::GetHostKey(size_t index) const {
+  const size_t entry = hosts_offset_ + index * kHostEntrySize;
+  return GetString(ReadUInt32(entry), ReadUInt32(entry + sizeof(uint32_t)));
+}
+
+base::StringPiece HTTPSEverywhereRuleset::Find(base::StringPiece key) const {
+  size_t low = 0;
+  size_t high = host_count_;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    const int compare = GetHostKey(middle).compare(key);
+    if (compare == 0) {
+      const uint32_t rule_id =
+          ReadUInt32(hosts_offset_ + middle * kHostEntrySize +
+                     2 * sizeof(uint32_t));
+      const size_t rule_entry = rules_offset_ + rule_id * kRuleEntrySize;
+      return GetString(ReadUInt32(rule_entry),
+                       ReadUInt32(rule_entry + sizeof(uint32_t)));
+    }
+    if (compare < 0)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return base::StringPiece();
+}
+
+}  // namespace brave_shields
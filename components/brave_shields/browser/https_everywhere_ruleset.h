@@ -0,0 +1,88 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULESET_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULESET_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/files/memory_mapped_file.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace leveldb {
+class DB;
+}
+
+namespace brave_shields {
+
+// Read-only HTTPS Everywhere ruleset which is memory mapped straight from
+// disk. The file maps lookup keys (reversed hosts such as "com.example" or
+// "com.example.*") to rule ids, and rule ids to the JSON rule strings, so
+// identical rules shared by many hosts are stored once.
+//
+// Layout, all integers are uint32_t in host byte order (the file is always
+// produced on the machine that reads it):
+//   header:   magic[8], version, host_count, rule_count
+//   hosts:    host_count x {key_offset, key_length, rule_id}, sorted by key
+//   rules:    rule_count x {offset, length}
+//   strings:  blob that all offsets above are relative to
+class HTTPSEverywhereRuleset {
+ public:
+  ~HTTPSEverywhereRuleset();
+
+  // Maps and validates the ruleset at |path|. Returns nullptr when the file
+  // is missing or malformed.
+  static std::unique_ptr<HTTPSEverywhereRuleset> Load(
+      const base::FilePath& path);
+  // Same as above, but for an in-memory buffer which must outlive the
+  // returned ruleset.
+  static std::unique_ptr<HTTPSEverywhereRuleset> LoadFromBuffer(
+      base::StringPiece buffer);
+
+  // Serializes |entries| (lookup key -> rule JSON) into the ruleset format.
+  static std::string Serialize(const std::map<std::string, std::string>& entries);
+
+  // Reads every entry of the legacy leveldb database and writes it to |path|
+  // in the ruleset format.
+  static bool ConvertFromLevelDB(leveldb::DB* db, const base::FilePath& path);
+
+  // Returns the rule for |key|, or an empty StringPiece. The result points
+  // into the mapping and is valid for the lifetime of the ruleset.
+  base::StringPiece Find(base::StringPiece key) const;
+
+  size_t host_count() const { return host_count_; }
+  size_t rule_count() const { return rule_count_; }
+
+ private:
+  HTTPSEverywhereRuleset();
+
+  bool Initialize(base::StringPiece buffer);
+  uint32_t ReadUInt32(size_t offset) const;
+  base::StringPiece GetString(uint32_t offset, uint32_t length) const;
+  base::StringPiece GetHostKey(size_t index) const;
+
+  base::MemoryMappedFile mapped_file_;
+  base::StringPiece buffer_;
+  size_t host_count_ = 0;
+  size_t rule_count_ = 0;
+  size_t hosts_offset_ = 0;
+  size_t rules_offset_ = 0;
+  size_t strings_offset_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSEverywhereRuleset);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULESET_H_
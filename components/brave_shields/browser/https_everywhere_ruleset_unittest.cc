@@ -0,0 +1,111 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_ruleset.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/leveldatabase/src/include/leveldb/db.h"
+
+using brave_shields::HTTPSEverywhereRuleset;
+
+namespace {
+
+const char kRule1[] = "[{\"r\":[{\"d\":1}]}]";
+const char kRule2[] =
+    "[{\"r\":[{\"f\":\"^http://www\\\\.example\\\\.org/\","
+    "\"t\":\"https://example.org/\"}]}]";
+
+std::map<std::string, std::string> GetTestEntries() {
+  return std::map<std::string, std::string>({
+      {"com.brave", kRule1},
+      {"com.brave.*", kRule1},
+      {"org.example", kRule2},
+      {"org.example.www", kRule2},
+      {"net.other", kRule1},
+  });
+}
+
+}  // namespace
+
+TEST(HTTPSEverywhereRulesetTest, RoundTripsLevelDB) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const std::map<std::string, std::string> entries = GetTestEntries();
+
+  leveldb::DB* db = nullptr;
+  leveldb::Options options;
+  options.create_if_missing = true;
+  ASSERT_TRUE(leveldb::DB::Open(
+                  options,
+                  temp_dir.GetPath().AppendASCII("httpse.leveldb")
+                      .AsUTF8Unsafe(),
+                  &db)
+                  .ok());
+  std::unique_ptr<leveldb::DB> db_holder(db);
+  for (const auto& entry : entries) {
+    ASSERT_TRUE(
+        db->Put(leveldb::WriteOptions(), entry.first, entry.second).ok());
+  }
+
+  base::FilePath ruleset_path = temp_dir.GetPath().AppendASCII("ruleset");
+  ASSERT_TRUE(HTTPSEverywhereRuleset::ConvertFromLevelDB(db, ruleset_path));
+
+  std::unique_ptr<HTTPSEverywhereRuleset> ruleset =
+      HTTPSEverywhereRuleset::Load(ruleset_path);
+  ASSERT_TRUE(ruleset);
+  EXPECT_EQ(entries.size(), ruleset->host_count());
+  // Identical rules are stored once.
+  EXPECT_EQ(2u, ruleset->rule_count());
+
+  // Every leveldb entry must be found with identical content.
+  std::unique_ptr<leveldb::Iterator> it(
+      db->NewIterator(leveldb::ReadOptions()));
+  size_t count = 0;
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    EXPECT_EQ(it->value().ToString(),
+              ruleset->Find(it->key().ToString()).as_string());
+    ++count;
+  }
+  EXPECT_EQ(entries.size(), count);
+
+  EXPECT_TRUE(ruleset->Find("com").empty());
+  EXPECT_TRUE(ruleset->Find("com.brave.www").empty());
+  EXPECT_TRUE(ruleset->Find("zzz").empty());
+  EXPECT_TRUE(ruleset->Find("").empty());
+}
+
+TEST(HTTPSEverywhereRulesetTest, RejectsMalformedData) {
+  const std::string serialized =
+      HTTPSEverywhereRuleset::Serialize(GetTestEntries());
+  ASSERT_TRUE(HTTPSEverywhereRuleset::LoadFromBuffer(serialized));
+
+  EXPECT_FALSE(HTTPSEverywhereRuleset::LoadFromBuffer(""));
+  EXPECT_FALSE(HTTPSEverywhereRuleset::LoadFromBuffer("BRHTTPSE"));
+  // Truncated tables or strings.
+  for (size_t size : {serialized.size() / 2, serialized.size() - 1}) {
+    std::string truncated = serialized.substr(0, size);
+    EXPECT_FALSE(HTTPSEverywhereRuleset::LoadFromBuffer(truncated)) << size;
+  }
+  std::string bad_magic = serialized;
+  bad_magic[0] = 'X';
+  EXPECT_FALSE(HTTPSEverywhereRuleset::LoadFromBuffer(bad_magic));
+}
+
+TEST(HTTPSEverywhereRulesetTest, Empty) {
+  const std::string serialized =
+      HTTPSEverywhereRuleset::Serialize(std::map<std::string, std::string>());
+  std::unique_ptr<HTTPSEverywhereRuleset> ruleset =
+      HTTPSEverywhereRuleset::LoadFromBuffer(serialized);
+  ASSERT_TRUE(ruleset);
+  EXPECT_EQ(0u, ruleset->host_count());
+  EXPECT_TRUE(ruleset->Find("com.brave").empty());
+}
@@ -12,19 +12,24 @@
 
 #include "base/base_paths.h"
 #include "base/bind.h"
+#include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
 #include "base/values.h"
+#include "brave/components/brave_shields/browser/https_everywhere_ruleset.h"
+#include "brave/components/brave_shields/common/features.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
 #include "third_party/re2/src/re2/re2.h"
 #include "third_party/zlib/google/zip.h"
 
 #define DAT_FILE "httpse.leveldb.zip"
 #define DAT_FILE_VERSION "6.0"
+#define RULESET_FILE "httpse.ruleset"
 #define HTTPSE_URLS_REDIRECTS_COUNT_QUEUE   1
 #define HTTPSE_URL_MAX_REDIRECTS_COUNT      5
 
@@ -65,16 +70,13 @@ std::vector<std::string> ExpandDomainForLookup(const std::string& domain) {
   }
   return resultDomains;
 }
-std::string leveldbGet(leveldb::DB* db, const std::string &key) {
-  if (!db) {
-    return "";
-  }
 
-  std::string value;
-  leveldb::Status s = db->Get(leveldb::ReadOptions(), key, &value);
-  return s.ok() ? value : "";
+// Field trial params are signed, so negative sizes fall back to the default
+// instead of wrapping around.
+size_t GetCacheParam(const base::FeatureParam<int>& param) {
+  const int value = param.Get();
+  return static_cast<size_t>(value > 0 ? value : param.default_value);
 }
-
 }  // namespace
 
 namespace brave_shields {
@@ -100,12 +102,20 @@ HTTPSEverywhereService::g_https_everywhere_component_base64_public_key_(
 HTTPSEverywhereService::HTTPSEverywhereService(
     BraveComponent::Delegate* delegate)
     : BaseBraveShieldsService(delegate),
-      level_db_(nullptr) {
+      recently_used_cache_(
+          GetCacheParam(features::kHTTPSEverywhereRewriteCacheSize),
+          GetCacheParam(features::kHTTPSEverywhereCacheShards)),
+      no_rule_host_cache_(
+          GetCacheParam(features::kHTTPSEverywhereNoRuleCacheSize),
+          GetCacheParam(features::kHTTPSEverywhereCacheShards)) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 HTTPSEverywhereService::~HTTPSEverywhereService() {
   Cleanup();
+  // Unmapping the ruleset may block, so it is released on the task runner.
+  if (ruleset_)
+    GetTaskRunner()->DeleteSoon(FROM_HERE, std::move(ruleset_));
 }
 
 void HTTPSEverywhereService::Cleanup() {
@@ -123,6 +133,38 @@ bool HTTPSEverywhereService::Init() {
 }
 
 void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  base::FilePath ruleset_path =
+      install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(RULESET_FILE);
+
+  // The ruleset is built once per component version and then mapped
+  // directly on every later start, so the zipped leveldb only has to be
+  // expanded the first time a version is seen.
+  if (!base::PathExists(ruleset_path) && !BuildRuleset(install_dir))
+    return;
+
+  CloseDatabase();
+
+  // Answers cached for the previous ruleset may no longer hold.
+  recently_used_cache_.clear();
+  no_rule_host_cache_.clear();
+
+  ruleset_ = HTTPSEverywhereRuleset::Load(ruleset_path);
+  if (ruleset_)
+    return;
+
+  // The ruleset is malformed or was written by an older format version, so
+  // it is rebuilt from the zipped database of this component right away.
+  base::DeleteFile(ruleset_path, false);
+  if (!BuildRuleset(install_dir))
+    return;
+
+  ruleset_ = HTTPSEverywhereRuleset::Load(ruleset_path);
+  if (!ruleset_)
+    LOG(ERROR) << "Failed to load rebuilt HTTPSE ruleset";
+}
+
+bool HTTPSEverywhereService::BuildRuleset(const base::FilePath& install_dir) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   base::FilePath zip_db_file_path =
       install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(DAT_FILE);
@@ -131,24 +173,31 @@ void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
   if (!zip::Unzip(zip_db_file_path, destination)) {
     LOG(ERROR) << "Failed to unzip database file "
                << zip_db_file_path.value().c_str();
-    return;
+    return false;
   }
 
-  CloseDatabase();
-
+  leveldb::DB* level_db = nullptr;
   leveldb::Options options;
   leveldb::Status status =
       leveldb::DB::Open(options,
                         unzipped_level_db_path.AsUTF8Unsafe(),
-                        &level_db_);
-  if (!status.ok() || !level_db_) {
-    level_db_ = nullptr;
+                        &level_db);
+  if (!status.ok() || !level_db) {
     LOG(ERROR) << "Level db open error "
                << unzipped_level_db_path.value().c_str()
                << ", error: " << status.ToString();
-    CloseDatabase();
-    return;
+    delete level_db;
+    return false;
   }
+
+  bool converted = HTTPSEverywhereRuleset::ConvertFromLevelDB(
+      level_db, destination.AppendASCII(RULESET_FILE));
+  delete level_db;
+  // The expanded database is no longer needed once converted.
+  base::DeleteFile(unzipped_level_db_path, true);
+  if (!converted)
+    LOG(ERROR) << "Failed to convert HTTPSE database";
+  return converted;
 }
 
 void HTTPSEverywhereService::OnComponentReady(
@@ -171,7 +220,7 @@ bool HTTPSEverywhereService::GetHTTPSURL(
   if (!url->is_valid())
     return false;
 
-  if (!IsInitialized() || !level_db_ || url->scheme() == url::kHttpsScheme) {
+  if (!IsInitialized() || !ruleset_ || url->scheme() == url::kHttpsScheme) {
     return false;
   }
   if (!ShouldHTTPSERedirect(request_identifier)) {
@@ -190,12 +239,18 @@ bool HTTPSEverywhereService::GetHTTPSURL(
     candidate_url = candidate_url.ReplaceComponents(replacements);
   }
 
+  bool no_rule;
+  if (no_rule_host_cache_.get(candidate_url.host(), &no_rule))
+    return false;
+
+  bool has_rule = false;
   const std::vector<std::string> domains =
       ExpandDomainForLookup(candidate_url.host());
-  for (auto domain : domains) {
-    std::string value = leveldbGet(level_db_, domain);
+  for (const auto& domain : domains) {
+    base::StringPiece value = ruleset_->Find(domain);
     if (!value.empty()) {
-      *new_url = ApplyHTTPSRule(candidate_url.spec(), value);
+      has_rule = true;
+      *new_url = ApplyHTTPSRule(candidate_url.spec(), value.as_string());
       if (0 != new_url->length()) {
         recently_used_cache_.add(candidate_url.spec(), *new_url);
         AddHTTPSEUrlToRedirectList(request_identifier);
@@ -204,6 +259,8 @@ bool HTTPSEverywhereService::GetHTTPSURL(
     }
   }
   recently_used_cache_.remove(candidate_url.spec());
+  if (!has_rule)
+    no_rule_host_cache_.add(candidate_url.host(), true);
   return false;
 }
 
@@ -221,10 +278,24 @@ bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), cached_url)) {
+  // Every request looks at the caches here first, so the hit ratios are
+  // recorded here only.
+  const bool rewrite_cache_hit =
+      recently_used_cache_.get(url->spec(), cached_url);
+  UMA_HISTOGRAM_BOOLEAN("Brave.HTTPSE.RewriteCacheHit", rewrite_cache_hit);
+  if (rewrite_cache_hit) {
     AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
+
+  // Hosts without any rule are answered right away, with no rewrite
+  bool no_rule;
+  const bool no_rule_cache_hit = no_rule_host_cache_.get(url->host(), &no_rule);
+  UMA_HISTOGRAM_BOOLEAN("Brave.HTTPSE.NoRuleCacheHit", no_rule_cache_hit);
+  if (no_rule_cache_hit) {
+    cached_url->clear();
+    return true;
+  }
   return false;
 }
 
@@ -384,10 +455,7 @@ std::string HTTPSEverywhereService::CorrecttoRuleToRE2Engine(
 
 void HTTPSEverywhereService::CloseDatabase() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  if (level_db_) {
-    delete level_db_;
-    level_db_ = nullptr;
-  }
+  ruleset_.reset();
 }
 
 // static
@@ -17,16 +17,14 @@
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
 
-namespace leveldb {
-class DB;
-}
-
 class HTTPSEverywhereServiceTest;
 
 using brave_component_updater::BraveComponent;
 
 namespace brave_shields {
 
+class HTTPSEverywhereRuleset;
+
 extern const char kHTTPSEverywhereComponentName[];
 extern const char kHTTPSEverywhereComponentId[];
 extern const char kHTTPSEverywhereComponentBase64PublicKey[];
@@ -51,6 +49,8 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
   bool GetHTTPSURL(const GURL* url,
                    const uint64_t& request_id,
                    std::string* new_url);
+  // Returns true if the answer for |url| is cached. |cached_url| is left
+  // empty when the host is known to have no rule.
   bool GetHTTPSURLFromCacheOnly(const GURL* url,
                                 const uint64_t& request_id,
                                 std::string* cached_url);
@@ -81,11 +81,18 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
   void CloseDatabase();
 
   void InitDB(const base::FilePath& install_dir);
+  // Expands the zipped leveldb shipped with the component and converts it
+  // into the mapped ruleset format.
+  bool BuildRuleset(const base::FilePath& install_dir);
 
   base::Lock httpse_get_urls_redirects_count_mutex_;
   std::vector<HTTPSE_REDIRECTS_COUNT_ST> httpse_urls_redirects_count_;
+  // URL spec -> rewritten HTTPS URL.
   HTTPSERecentlyUsedCache<std::string> recently_used_cache_;
-  leveldb::DB* level_db_;
+  // Hosts for which no lookup key has a rule, so every URL on them can be
+  // answered without touching the ruleset.
+  HTTPSERecentlyUsedCache<bool> no_rule_host_cache_;
+  std::unique_ptr<HTTPSEverywhereRuleset> ruleset_;
 
   SEQUENCE_CHECKER(sequence_checker_);
   DISALLOW_COPY_AND_ASSIGN(HTTPSEverywhereService);
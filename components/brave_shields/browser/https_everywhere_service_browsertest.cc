@@ -5,6 +5,7 @@
 
 #include "base/task/post_task.h"
 #include "base/path_service.h"
+#include "base/test/metrics/histogram_tester.h"
 #include "base/test/thread_test_helper.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/brave_paths.h"
@@ -122,6 +123,31 @@ IN_PROC_BROWSER_TEST_F(HTTPSEverywhereServiceTest, NoRedirectsNotKnownSite) {
             contents->GetLastCommittedURL().ReplaceComponents(clear_port));
 }
 
+// Cache lookups on the fast path record whether they hit, so the hit ratio
+// of each cache can be followed.
+IN_PROC_BROWSER_TEST_F(HTTPSEverywhereServiceTest, RecordsCacheHitRatios) {
+  ASSERT_TRUE(InstallHTTPSEverywhereExtension());
+  base::HistogramTester histogram_tester;
+
+  // The rewrite cache is keyed by the URL with its port, which the test
+  // rules ignore, so only its misses show up here.
+  GURL rewritten_url = embedded_test_server()->GetURL("www.digg.com", "/");
+  ui_test_utils::NavigateToURL(browser(), rewritten_url);
+  EXPECT_GE(histogram_tester.GetBucketCount("Brave.HTTPSE.RewriteCacheHit",
+                                            false), 1);
+
+  // Hosts without rules are cached by host, so the second load hits.
+  GURL no_rule_url = embedded_test_server()->GetURL("www.brianbondy.com", "/");
+  ui_test_utils::NavigateToURL(browser(), no_rule_url);
+  EXPECT_GE(histogram_tester.GetBucketCount("Brave.HTTPSE.NoRuleCacheHit",
+                                            false), 1);
+  EXPECT_EQ(histogram_tester.GetBucketCount("Brave.HTTPSE.NoRuleCacheHit",
+                                            true), 0);
+  ui_test_utils::NavigateToURL(browser(), no_rule_url);
+  EXPECT_GE(histogram_tester.GetBucketCount("Brave.HTTPSE.NoRuleCacheHit",
+                                            true), 1);
+}
+
 // Make sure iframes that should redirect to HTTPS actually redirect and that
 // the header is intact.
 IN_PROC_BROWSER_TEST_F(HTTPSEverywhereServiceTest, RedirectsKnownSiteInIframe) {
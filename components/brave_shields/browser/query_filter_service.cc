@@ -0,0 +1,211 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/query_filter_service.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_util.h"
+#include "base/task/post_task.h"
+#include "base/values.h"
+#include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_component_updater/browser/local_data_files_service.h"
+#include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace brave_shields {
+
+namespace {
+
+const char* const kDefaultTrackers[] = {
+  "fbclid",
+  "gclid",
+  "msclkid",
+  "mc_eid",
+};
+
+}  // namespace
+
+bool QueryFilter::CaseInsensitiveLess::operator()(
+    base::StringPiece lhs,
+    base::StringPiece rhs) const {
+  return base::CompareCaseInsensitiveASCII(lhs, rhs) < 0;
+}
+
+QueryFilter::QueryFilter(const std::vector<std::string>& trackers)
+    : trackers_(trackers.begin(), trackers.end()) {
+  for (const auto& tracker : trackers_)
+    max_tracker_length_ = std::max(max_tracker_length_, tracker.size());
+}
+
+QueryFilter::~QueryFilter() = default;
+
+// static
+const QueryFilter& QueryFilter::Default() {
+  static base::NoDestructor<scoped_refptr<QueryFilter>> query_filter(
+      base::MakeRefCounted<QueryFilter>(std::vector<std::string>(
+          std::begin(kDefaultTrackers), std::end(kDefaultTrackers))));
+  return **query_filter;
+}
+
+// static
+scoped_refptr<QueryFilter> QueryFilter::Parse(const std::string& contents) {
+  if (contents.empty()) {
+    LOG(ERROR) << "Could not obtain query filter data";
+    return nullptr;
+  }
+  base::Optional<base::Value> root = base::JSONReader::Read(contents);
+  if (!root || !root->is_dict()) {
+    LOG(ERROR) << "Failed to parse query filter data";
+    return nullptr;
+  }
+  const base::Value* trackers_value = root->FindListKey("trackers");
+  if (!trackers_value) {
+    LOG(ERROR) << "Failed to parse query filter data";
+    return nullptr;
+  }
+
+  std::vector<std::string> trackers;
+  for (const base::Value& tracker : trackers_value->GetList()) {
+    if (tracker.is_string() && !tracker.GetString().empty())
+      trackers.push_back(tracker.GetString());
+  }
+  return base::MakeRefCounted<QueryFilter>(trackers);
+}
+
+bool QueryFilter::IsTracker(base::StringPiece param) const {
+  const size_t separator = param.find('=');
+  // Parameters without a value are left alone.
+  if (separator == base::StringPiece::npos ||
+      separator > max_tracker_length_ ||
+      separator + 1 == param.size()) {
+    return false;
+  }
+  return trackers_.find(param.substr(0, separator)) != trackers_.end();
+}
+
+bool QueryFilter::Filter(base::StringPiece query,
+                         std::string* filtered_query) const {
+  DCHECK(filtered_query);
+  // The result is only built once the first tracker is found.
+  std::string result;
+  bool found_tracker = false;
+  bool has_kept_param = false;
+  size_t begin = 0;
+  while (true) {
+    size_t end = query.find('&', begin);
+    if (end == base::StringPiece::npos)
+      end = query.size();
+    const base::StringPiece param = query.substr(begin, end - begin);
+
+    if (IsTracker(param)) {
+      if (!found_tracker) {
+        found_tracker = true;
+        result.reserve(query.size());
+        // Everything before the tracker is kept as is, minus the separator.
+        if (begin > 0) {
+          query.substr(0, begin - 1).AppendToString(&result);
+          has_kept_param = true;
+        }
+      }
+    } else if (found_tracker) {
+      if (has_kept_param)
+        result.push_back('&');
+      param.AppendToString(&result);
+      has_kept_param = true;
+    }
+
+    if (end == query.size())
+      break;
+    begin = end + 1;
+  }
+
+  if (!found_tracker)
+    return false;
+  *filtered_query = std::move(result);
+  return true;
+}
+
+QueryFilterService::QueryFilterService(
+    LocalDataFilesService* local_data_files_service)
+    : LocalDataFilesObserver(local_data_files_service,
+                             base::TaskPriority::USER_BLOCKING),
+      weak_factory_(this),
+      weak_factory_io_thread_(this) {
+}
+
+QueryFilterService::~QueryFilterService() {
+}
+
+const QueryFilter& QueryFilterService::GetQueryFilter() const {
+  const scoped_refptr<QueryFilter>& query_filter =
+      BrowserThread::CurrentlyOn(BrowserThread::IO)
+          ? query_filter_io_thread_
+          : query_filter_;
+  return query_filter ? *query_filter : QueryFilter::Default();
+}
+
+// static
+scoped_refptr<QueryFilter> QueryFilterService::LoadQueryFilter(
+    const base::FilePath& dat_file_path) {
+  // Component versions which don't ship the list yet keep the default one.
+  if (!base::PathExists(dat_file_path)) {
+    VLOG(1) << "No query filter data in the local data files component";
+    return nullptr;
+  }
+  return QueryFilter::Parse(
+      brave_component_updater::GetDATFileAsString(dat_file_path));
+}
+
+void QueryFilterService::OnQueryFilterLoaded(
+    scoped_refptr<QueryFilter> query_filter) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Keep the current list if the new one couldn't be read.
+  if (!query_filter)
+    return;
+  query_filter_ = query_filter;
+
+  base::PostTask(
+      FROM_HERE, {BrowserThread::IO},
+      base::BindOnce(&QueryFilterService::OnQueryFilterLoadedOnIOThread,
+                     weak_factory_io_thread_.GetWeakPtr(),
+                     std::move(query_filter)));
+}
+
+void QueryFilterService::OnQueryFilterLoadedOnIOThread(
+    scoped_refptr<QueryFilter> query_filter) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  query_filter_io_thread_ = std::move(query_filter);
+}
+
+void QueryFilterService::OnComponentReady(
+    const std::string& component_id,
+    const base::FilePath& install_dir,
+    const std::string& manifest) {
+  base::FilePath dat_file_path = install_dir
+      .AppendASCII(QUERY_FILTER_DAT_FILE_VERSION)
+      .AppendASCII(QUERY_FILTER_DAT_FILE);
+
+  LoadData("QueryFilter",
+           base::BindOnce(&QueryFilterService::LoadQueryFilter, dat_file_path),
+           base::BindOnce(&QueryFilterService::OnQueryFilterLoaded,
+                          weak_factory_.GetWeakPtr()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<QueryFilterService> QueryFilterServiceFactory(
+    LocalDataFilesService* local_data_files_service) {
+  return std::make_unique<QueryFilterService>(local_data_files_service);
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,105 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_QUERY_FILTER_SERVICE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_QUERY_FILTER_SERVICE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/strings/string_piece.h"
+#include "brave/components/brave_component_updater/browser/local_data_files_observer.h"
+
+#define QUERY_FILTER_DAT_FILE "QueryFilter.json"
+#define QUERY_FILTER_DAT_FILE_VERSION "1"
+
+using brave_component_updater::LocalDataFilesObserver;
+using brave_component_updater::LocalDataFilesService;
+
+namespace brave_shields {
+
+// Immutable set of tracking query string parameters. A single instance is
+// shared by the UI and IO thread and replaced wholesale on update.
+class QueryFilter : public base::RefCountedThreadSafe<QueryFilter> {
+ public:
+  explicit QueryFilter(const std::vector<std::string>& trackers);
+
+  // The trackers stripped until the local data files component is loaded.
+  static const QueryFilter& Default();
+
+  // Parses the query filter JSON, returns nullptr on failure.
+  static scoped_refptr<QueryFilter> Parse(const std::string& contents);
+
+  // Strips tracker parameters with a non-empty value from |query| in a single
+  // pass. Parameters are only split on literal '&' and '=' so encoded
+  // separators stay part of the parameter they are in. Returns false and
+  // leaves |filtered_query| untouched if |query| has no trackers.
+  bool Filter(base::StringPiece query, std::string* filtered_query) const;
+
+  size_t size() const { return trackers_.size(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<QueryFilter>;
+  ~QueryFilter();
+
+  struct CaseInsensitiveLess {
+    using is_transparent = void;
+    bool operator()(base::StringPiece lhs, base::StringPiece rhs) const;
+  };
+
+  bool IsTracker(base::StringPiece param) const;
+
+  base::flat_set<std::string, CaseInsensitiveLess> trackers_;
+  size_t max_tracker_length_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(QueryFilter);
+};
+
+// The brave shields service in charge of the tracking query string parameter
+// list.
+class QueryFilterService : public LocalDataFilesObserver {
+ public:
+  explicit QueryFilterService(LocalDataFilesService* local_data_files_service);
+  ~QueryFilterService() override;
+
+  // Returns the filter for the calling thread.
+  const QueryFilter& GetQueryFilter() const;
+
+  // implementation of LocalDataFilesObserver
+  void OnComponentReady(const std::string& component_id,
+                        const base::FilePath& install_dir,
+                        const std::string& manifest) override;
+
+  // Reads the query filter from |dat_file_path|, returns nullptr if the file
+  // is missing or invalid.
+  static scoped_refptr<QueryFilter> LoadQueryFilter(
+      const base::FilePath& dat_file_path);
+
+ private:
+  void OnQueryFilterLoaded(scoped_refptr<QueryFilter> query_filter);
+  void OnQueryFilterLoadedOnIOThread(scoped_refptr<QueryFilter> query_filter);
+
+  scoped_refptr<QueryFilter> query_filter_;
+  scoped_refptr<QueryFilter> query_filter_io_thread_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<QueryFilterService> weak_factory_;
+  base::WeakPtrFactory<QueryFilterService> weak_factory_io_thread_;
+  DISALLOW_COPY_AND_ASSIGN(QueryFilterService);
+};
+
+// Creates the QueryFilterService
+std::unique_ptr<QueryFilterService> QueryFilterServiceFactory(
+    LocalDataFilesService* local_data_files_service);
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_QUERY_FILTER_SERVICE_H_
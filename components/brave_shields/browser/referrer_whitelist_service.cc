@@ -5,12 +5,12 @@
 
 #include "brave/components/brave_shields/browser/referrer_whitelist_service.h"
 
+#include <memory>
 #include <utility>
 
 #include "base/bind.h"
 #include "base/json/json_reader.h"
 #include "base/task/post_task.h"
-#include "base/task_runner_util.h"
 #include "base/values.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
@@ -25,7 +25,8 @@ namespace brave_shields {
 
 ReferrerWhitelistService::ReferrerWhitelistService(
     LocalDataFilesService* local_data_files_service)
-    : LocalDataFilesObserver(local_data_files_service),
+    : LocalDataFilesObserver(local_data_files_service,
+                             base::TaskPriority::USER_BLOCKING),
       weak_factory_(this),
       weak_factory_io_thread_(this) {
 }
@@ -33,81 +34,109 @@ ReferrerWhitelistService::ReferrerWhitelistService(
 ReferrerWhitelistService::~ReferrerWhitelistService() {
 }
 
-ReferrerWhitelistService::ReferrerWhitelist::ReferrerWhitelist() = default;
 ReferrerWhitelistService::ReferrerWhitelist::ReferrerWhitelist(
-  const ReferrerWhitelist& other) = default;
-ReferrerWhitelistService::ReferrerWhitelist::~ReferrerWhitelist() = default;
-
-bool ReferrerWhitelistService::IsWhitelisted(
-    const GURL& first_party_origin, const GURL& subresource_url) const {
-  if (BrowserThread::CurrentlyOn(BrowserThread::IO)) {
-    return IsWhitelisted(
-        referrer_whitelist_io_thread_, first_party_origin, subresource_url);
-  } else {
-    return IsWhitelisted(
-        referrer_whitelist_, first_party_origin, subresource_url);
+    std::vector<URLPattern> first_party_patterns,
+    std::vector<std::vector<URLPattern>> subresource_patterns)
+    : first_party_patterns_(std::move(first_party_patterns)) {
+  DCHECK_EQ(first_party_patterns_.size(), subresource_patterns.size());
+  for (auto& patterns : subresource_patterns) {
+    subresource_patterns_.push_back(
+        std::make_unique<brave::HostIndexedURLPatternSet>(
+            std::move(patterns)));
   }
 }
 
-bool ReferrerWhitelistService::IsWhitelisted(
-    const std::vector<ReferrerWhitelist>& whitelist,
-    const GURL& first_party_origin,
-    const GURL& subresource_url) const {
-  for (auto rw : whitelist) {
-    if (rw.first_party_pattern.MatchesURL(first_party_origin)) {
-      for (auto subresource_pattern : rw.subresource_pattern_list) {
-        if (subresource_pattern.MatchesURL(subresource_url)) {
-          return true;
-        }
-      }
-    }
-  }
-  return false;
-}
+ReferrerWhitelistService::ReferrerWhitelist::~ReferrerWhitelist() = default;
 
-void ReferrerWhitelistService::OnDATFileDataReady(std::string contents) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  referrer_whitelist_.clear();
+// static
+scoped_refptr<ReferrerWhitelistService::ReferrerWhitelist>
+ReferrerWhitelistService::ReferrerWhitelist::Parse(
+    const std::string& contents) {
   if (contents.empty()) {
     LOG(ERROR) << "Could not obtain referrer whitelist data";
-    return;
+    return nullptr;
   }
   base::Optional<base::Value> root = base::JSONReader::Read(contents);
-  contents.clear();
-  if (!root) {
+  if (!root || !root->is_dict()) {
+    LOG(ERROR) << "Failed to parse referrer whitelist data";
+    return nullptr;
+  }
+  const base::Value* whitelist = root->FindListKey("whitelist");
+  if (!whitelist) {
     LOG(ERROR) << "Failed to parse referrer whitelist data";
-    return;
+    return nullptr;
   }
-  base::DictionaryValue* root_dict = nullptr;
-  root->GetAsDictionary(&root_dict);
-  base::ListValue* whitelist = nullptr;
-  root_dict->GetList("whitelist", &whitelist);
-  for (base::Value& origins : whitelist->GetList()) {
-    base::DictionaryValue* origins_dict = nullptr;
-    origins.GetAsDictionary(&origins_dict);
-    for (const auto& it : origins_dict->DictItems()) {
-      ReferrerWhitelist rw;
-      rw.first_party_pattern = URLPattern(
-        URLPattern::SCHEME_HTTP|URLPattern::SCHEME_HTTPS, it.first);
-      URLPatternList subresource_pattern_list;
-      for (base::Value& subresource_value : it.second.GetList()) {
-        rw.subresource_pattern_list.push_back(URLPattern(
-          URLPattern::SCHEME_HTTP|URLPattern::SCHEME_HTTPS,
-          subresource_value.GetString()));
+
+  std::vector<URLPattern> first_party_patterns;
+  std::vector<std::vector<URLPattern>> subresource_patterns;
+  for (const base::Value& origins : whitelist->GetList()) {
+    if (!origins.is_dict())
+      continue;
+    for (const auto& it : origins.DictItems()) {
+      if (!it.second.is_list())
+        continue;
+      first_party_patterns.push_back(URLPattern(
+          URLPattern::SCHEME_HTTP|URLPattern::SCHEME_HTTPS, it.first));
+      std::vector<URLPattern> subresource_pattern_list;
+      for (const base::Value& subresource_value : it.second.GetList()) {
+        if (!subresource_value.is_string())
+          continue;
+        subresource_pattern_list.push_back(URLPattern(
+            URLPattern::SCHEME_HTTP|URLPattern::SCHEME_HTTPS,
+            subresource_value.GetString()));
       }
-      referrer_whitelist_.push_back(rw);
+      subresource_patterns.push_back(std::move(subresource_pattern_list));
     }
   }
 
+  return base::MakeRefCounted<ReferrerWhitelist>(
+      std::move(first_party_patterns), std::move(subresource_patterns));
+}
+
+bool ReferrerWhitelistService::ReferrerWhitelist::IsWhitelisted(
+    const GURL& first_party_origin,
+    const GURL& subresource_url) const {
+  std::vector<size_t> matches;
+  first_party_patterns_.GetMatches(first_party_origin, &matches);
+  for (size_t index : matches) {
+    if (subresource_patterns_[index]->MatchesURL(subresource_url))
+      return true;
+  }
+  return false;
+}
+
+bool ReferrerWhitelistService::IsWhitelisted(
+    const GURL& first_party_origin, const GURL& subresource_url) const {
+  const scoped_refptr<ReferrerWhitelist>& whitelist =
+      BrowserThread::CurrentlyOn(BrowserThread::IO)
+          ? referrer_whitelist_io_thread_
+          : referrer_whitelist_;
+  return whitelist &&
+         whitelist->IsWhitelisted(first_party_origin, subresource_url);
+}
+
+// static
+scoped_refptr<ReferrerWhitelistService::ReferrerWhitelist>
+ReferrerWhitelistService::LoadReferrerWhitelist(
+    const base::FilePath& dat_file_path) {
+  return ReferrerWhitelist::Parse(
+      brave_component_updater::GetDATFileAsString(dat_file_path));
+}
+
+void ReferrerWhitelistService::OnReferrerWhitelistLoaded(
+    scoped_refptr<ReferrerWhitelist> whitelist) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  referrer_whitelist_ = whitelist;
+
   base::PostTask(
       FROM_HERE, {BrowserThread::IO},
-      base::BindOnce(&ReferrerWhitelistService::OnDATFileDataReadyOnIOThread,
-                     weak_factory_io_thread_.GetWeakPtr(),
-                     referrer_whitelist_));
+      base::BindOnce(
+          &ReferrerWhitelistService::OnReferrerWhitelistLoadedOnIOThread,
+          weak_factory_io_thread_.GetWeakPtr(), std::move(whitelist)));
 }
 
-void ReferrerWhitelistService::OnDATFileDataReadyOnIOThread(
-    std::vector<ReferrerWhitelist> whitelist) {
+void ReferrerWhitelistService::OnReferrerWhitelistLoadedOnIOThread(
+    scoped_refptr<ReferrerWhitelist> whitelist) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
   referrer_whitelist_io_thread_ = std::move(whitelist);
 }
@@ -120,13 +149,13 @@ void ReferrerWhitelistService::OnComponentReady(
       .AppendASCII(REFERRER_DAT_FILE_VERSION)
       .AppendASCII(REFERRER_DAT_FILE);
 
-  base::PostTaskAndReplyWithResult(
-      local_data_files_service()->GetTaskRunner().get(),
-      FROM_HERE,
-      base::BindOnce(&brave_component_updater::GetDATFileAsString,
-                     dat_file_path),
-      base::BindOnce(&ReferrerWhitelistService::OnDATFileDataReady,
-                     weak_factory_.GetWeakPtr()));
+  // Parsing and indexing happen on the thread pool; the resulting immutable
+  // whitelist is then shared by both threads.
+  LoadData("ReferrerWhitelist",
+           base::BindOnce(&ReferrerWhitelistService::LoadReferrerWhitelist,
+                          dat_file_path),
+           base::BindOnce(&ReferrerWhitelistService::OnReferrerWhitelistLoaded,
+                          weak_factory_.GetWeakPtr()));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -11,16 +11,18 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
+#include "brave/common/host_indexed_url_pattern_set.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_observer.h"
-#include "extensions/common/url_pattern.h"
 #include "url/gurl.h"
 
 #define REFERRER_DAT_FILE "ReferrerWhitelist.json"
 #define REFERRER_DAT_FILE_VERSION "1"
 
 class ReferrerWhitelistServiceTest;
+class ReferrerWhitelistTest;
 
 using brave_component_updater::LocalDataFilesObserver;
 using brave_component_updater::LocalDataFilesService;
@@ -44,25 +46,44 @@ class ReferrerWhitelistService : public LocalDataFilesObserver {
 
  private:
   friend class ::ReferrerWhitelistServiceTest;
-
-  struct ReferrerWhitelist {
-    URLPattern first_party_pattern;
-    URLPatternList subresource_pattern_list;
-    ReferrerWhitelist();
-    ReferrerWhitelist(const ReferrerWhitelist& other);
+  friend class ::ReferrerWhitelistTest;
+
+  // Immutable, host-indexed view of the referrer whitelist. A single instance
+  // is shared by the UI and IO thread and replaced wholesale on update.
+  class ReferrerWhitelist
+      : public base::RefCountedThreadSafe<ReferrerWhitelist> {
+   public:
+    ReferrerWhitelist(
+        std::vector<URLPattern> first_party_patterns,
+        std::vector<std::vector<URLPattern>> subresource_patterns);
+
+    // Parses the whitelist JSON, returns nullptr on failure.
+    static scoped_refptr<ReferrerWhitelist> Parse(const std::string& contents);
+
+    bool IsWhitelisted(const GURL& first_party_origin,
+                       const GURL& subresource_url) const;
+    size_t size() const { return first_party_patterns_.size(); }
+
+   private:
+    friend class base::RefCountedThreadSafe<ReferrerWhitelist>;
     ~ReferrerWhitelist();
-  };
 
-  bool IsWhitelisted(const std::vector<ReferrerWhitelist>& whitelist,
-                     const GURL& first_party_origin,
-                     const GURL& subresource_url) const;
-  void OnDATFileDataReady(std::string contents);
-  void OnDATFileDataReadyOnIOThread(std::vector<ReferrerWhitelist> whitelist);
+    brave::HostIndexedURLPatternSet first_party_patterns_;
+    // Subresource patterns for the first party pattern at the same index.
+    std::vector<std::unique_ptr<brave::HostIndexedURLPatternSet>>
+        subresource_patterns_;
+
+    DISALLOW_COPY_AND_ASSIGN(ReferrerWhitelist);
+  };
 
-  typedef std::vector<URLPattern> URLPatternList;
+  static scoped_refptr<ReferrerWhitelist> LoadReferrerWhitelist(
+      const base::FilePath& dat_file_path);
+  void OnReferrerWhitelistLoaded(scoped_refptr<ReferrerWhitelist> whitelist);
+  void OnReferrerWhitelistLoadedOnIOThread(
+      scoped_refptr<ReferrerWhitelist> whitelist);
 
-  std::vector<ReferrerWhitelist> referrer_whitelist_;
-  std::vector<ReferrerWhitelist> referrer_whitelist_io_thread_;
+  scoped_refptr<ReferrerWhitelist> referrer_whitelist_;
+  scoped_refptr<ReferrerWhitelist> referrer_whitelist_io_thread_;
 
   SEQUENCE_CHECKER(sequence_checker_);
   base::WeakPtrFactory<ReferrerWhitelistService> weak_factory_;
@@ -26,13 +26,15 @@ class ReferrerWhitelistServiceTest : public BaseLocalDataFilesBrowserTest {
   }
 
   int GetWhitelistSize() {
-    return g_brave_browser_process->referrer_whitelist_service()
-        ->referrer_whitelist_.size();
+    const auto& whitelist =
+        g_brave_browser_process->referrer_whitelist_service()
+            ->referrer_whitelist_;
+    return whitelist ? whitelist->size() : 0;
   }
 
   void ClearWhitelist() {
     g_brave_browser_process->referrer_whitelist_service()
-        ->referrer_whitelist_.clear();
+        ->referrer_whitelist_ = nullptr;
   }
 };
 
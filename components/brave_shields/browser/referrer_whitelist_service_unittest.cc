@@ -0,0 +1,87 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/referrer_whitelist_service.h"
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
+#include "brave/common/brave_paths.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using brave_shields::ReferrerWhitelistService;
+
+class ReferrerWhitelistTest : public testing::Test {
+ public:
+  void SetUp() override {
+    brave::RegisterPathProvider();
+    base::FilePath test_data_dir;
+    ASSERT_TRUE(base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir));
+    std::string contents;
+    ASSERT_TRUE(base::ReadFileToString(
+        test_data_dir.AppendASCII("referrer-whitelist-data")
+            .AppendASCII(REFERRER_DAT_FILE_VERSION)
+            .AppendASCII(REFERRER_DAT_FILE),
+        &contents));
+    whitelist_ = ReferrerWhitelistService::ReferrerWhitelist::Parse(contents);
+    ASSERT_TRUE(whitelist_);
+  }
+
+ protected:
+  bool IsWhitelisted(const std::string& first_party_origin,
+                     const std::string& subresource_url) {
+    return whitelist_->IsWhitelisted(GURL(first_party_origin),
+                                     GURL(subresource_url));
+  }
+
+  size_t GetWhitelistSize() { return whitelist_->size(); }
+
+  bool Parses(const std::string& contents) {
+    return !!ReferrerWhitelistService::ReferrerWhitelist::Parse(contents);
+  }
+
+ private:
+  scoped_refptr<ReferrerWhitelistService::ReferrerWhitelist> whitelist_;
+};
+
+TEST_F(ReferrerWhitelistTest, Fixture) {
+  EXPECT_EQ(4u, GetWhitelistSize());
+
+  EXPECT_FALSE(IsWhitelisted("https://test.com",
+                             "https://video-zyz1-9.xy.fbcdn.net"));
+  EXPECT_TRUE(IsWhitelisted("https://www.facebook.com",
+                            "https://video-zyz1-9.xy.fbcdn.net"));
+  EXPECT_FALSE(IsWhitelisted("https://www.facebook.com", "https://test.com"));
+  EXPECT_TRUE(IsWhitelisted("https://www.reddit.com/",
+                            "https://www.redditmedia.com/97"));
+  EXPECT_TRUE(IsWhitelisted("https://www.reddit.com/",
+                            "https://cdn.embedly.com/157"));
+  EXPECT_TRUE(IsWhitelisted("https://www.reddit.com/", "https://imgur.com/1"));
+  EXPECT_FALSE(IsWhitelisted("https://www.reddit.com", "https://test.com"));
+  EXPECT_FALSE(IsWhitelisted("https://www.test.com", "https://imgur.com/173"));
+  EXPECT_TRUE(IsWhitelisted("https://www.test.com",
+                            "https://use.typekit.net/193"));
+  EXPECT_TRUE(IsWhitelisted("https://www.test.com",
+                            "https://cloud.typography.com/199"));
+  EXPECT_TRUE(IsWhitelisted("http://binance.com", "https://api.geetest.com/"));
+  EXPECT_FALSE(IsWhitelisted("http://binance.com", "http://api.geetest.com/"));
+  EXPECT_TRUE(IsWhitelisted(
+      "https://accounts.google.com",
+      "https://content.googleapis.com/cryptauth/v1/authzen/awaittx"));
+  EXPECT_FALSE(IsWhitelisted(
+      "https://accounts.google.com",
+      "https://ajax.googleapis.com/ajax/libs/d3js/5.7.0/d3.min.js"));
+}
+
+TEST_F(ReferrerWhitelistTest, InvalidData) {
+  EXPECT_FALSE(Parses(""));
+  EXPECT_FALSE(Parses("not json"));
+  EXPECT_FALSE(Parses("[]"));
+  EXPECT_FALSE(Parses("{}"));
+  EXPECT_TRUE(Parses("{\"whitelist\": []}"));
+}
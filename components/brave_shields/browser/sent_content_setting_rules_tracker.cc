@@ -0,0 +1,73 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/sent_content_setting_rules_tracker.h"
+
+#include "base/memory/singleton.h"
+#include "components/content_settings/core/browser/content_settings_utils.h"
+#include "content/public/browser/browser_thread.h"
+
+namespace brave_shields {
+
+// static
+SentContentSettingRulesTracker* SentContentSettingRulesTracker::GetInstance() {
+  return base::Singleton<SentContentSettingRulesTracker>::get();
+}
+
+SentContentSettingRulesTracker::SentContentSettingRulesTracker()
+    : observer_(this) {}
+
+SentContentSettingRulesTracker::~SentContentSettingRulesTracker() = default;
+
+bool SentContentSettingRulesTracker::UpdateVersion(
+    content::RenderProcessHost* process,
+    uint64_t version) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!observer_.IsObserving(process))
+    observer_.Add(process);
+  auto it = versions_.find(process->GetID());
+  if (it != versions_.end() && it->second == version)
+    return false;
+  versions_[process->GetID()] = version;
+  return true;
+}
+
+void SentContentSettingRulesTracker::SendRulesIfNeeded(
+    const HostContentSettingsMap* map,
+    uint64_t version,
+    const std::vector<content::RenderProcessHost*>& processes,
+    const SendRulesCallback& send) {
+  RendererContentSettingRules rules;
+  bool rules_built = false;
+  for (content::RenderProcessHost* process : processes) {
+    if (!UpdateVersion(process, version))
+      continue;
+    if (!rules_built) {
+      GetRendererContentSettingRules(map, &rules);
+      rules_built = true;
+    }
+    send.Run(process, rules);
+  }
+}
+
+void SentContentSettingRulesTracker::RenderProcessExited(
+    content::RenderProcessHost* host,
+    const content::ChildProcessTerminationInfo& info) {
+  Forget(host);
+}
+
+void SentContentSettingRulesTracker::RenderProcessHostDestroyed(
+    content::RenderProcessHost* host) {
+  Forget(host);
+}
+
+void SentContentSettingRulesTracker::Forget(content::RenderProcessHost* host) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  versions_.erase(host->GetID());
+  if (observer_.IsObserving(host))
+    observer_.Remove(host);
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,83 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SENT_CONTENT_SETTING_RULES_TRACKER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SENT_CONTENT_SETTING_RULES_TRACKER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/scoped_observer.h"
+#include "components/content_settings/core/common/content_settings.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+class HostContentSettingsMap;
+
+namespace base {
+template <typename T>
+struct DefaultSingletonTraits;
+}  // namespace base
+
+namespace brave_shields {
+
+// Remembers the ContentSettingRulesVersion of the content setting rules last
+// sent to each renderer process, keyed by RenderProcessHost::GetID(), so the
+// rules are neither rebuilt nor sent again to frames of a process that
+// already has them. The version is dropped when the renderer exits or its
+// host is destroyed, so a relaunched renderer gets the rules again. Only used
+// on the UI thread.
+class SentContentSettingRulesTracker
+    : public content::RenderProcessHostObserver {
+ public:
+  using SendRulesCallback =
+      base::RepeatingCallback<void(content::RenderProcessHost*,
+                                   const RendererContentSettingRules&)>;
+
+  static SentContentSettingRulesTracker* GetInstance();
+
+  // Records |version| for |process| and returns true if it differs from the
+  // version last recorded for that process.
+  bool UpdateVersion(content::RenderProcessHost* process, uint64_t version);
+
+  // Runs |send| with the rules of |map| for each of |processes| which hasn't
+  // been sent |version| of them yet. The rules are built at most once, and
+  // not at all when every process is up to date.
+  void SendRulesIfNeeded(
+      const HostContentSettingsMap* map,
+      uint64_t version,
+      const std::vector<content::RenderProcessHost*>& processes,
+      const SendRulesCallback& send);
+
+  // content::RenderProcessHostObserver overrides.
+  void RenderProcessExited(
+      content::RenderProcessHost* host,
+      const content::ChildProcessTerminationInfo& info) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+ private:
+  friend struct base::DefaultSingletonTraits<SentContentSettingRulesTracker>;
+  friend class SentContentSettingRulesTrackerTest;
+
+  SentContentSettingRulesTracker();
+  ~SentContentSettingRulesTracker() override;
+
+  void Forget(content::RenderProcessHost* host);
+
+  std::map<int, uint64_t> versions_;
+  ScopedObserver<content::RenderProcessHost,
+                 content::RenderProcessHostObserver>
+      observer_;
+
+  DISALLOW_COPY_AND_ASSIGN(SentContentSettingRulesTracker);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SENT_CONTENT_SETTING_RULES_TRACKER_H_
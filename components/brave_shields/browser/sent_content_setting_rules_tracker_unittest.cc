@@ -0,0 +1,153 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/sent_content_setting_rules_tracker.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/test/bind_test_util.h"
+#include "brave/components/brave_shields/browser/content_setting_rules_version.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/test/base/testing_profile.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "components/content_settings/core/common/content_settings.mojom.h"
+#include "content/public/test/browser_task_environment.h"
+#include "content/public/test/mock_render_process_host.h"
+#include "content/public/test/test_browser_context.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+class SentContentSettingRulesTrackerTest : public testing::Test {
+ public:
+  SentContentSettingRulesTrackerTest() = default;
+  ~SentContentSettingRulesTrackerTest() override = default;
+
+  void TearDown() override {
+    // The tracker is a process-wide singleton; don't leak versions into
+    // other tests.
+    tracker()->versions_.clear();
+  }
+
+  SentContentSettingRulesTracker* tracker() {
+    return SentContentSettingRulesTracker::GetInstance();
+  }
+
+  content::TestBrowserContext* browser_context() { return &browser_context_; }
+
+ private:
+  content::BrowserTaskEnvironment task_environment_;
+  content::TestBrowserContext browser_context_;
+};
+
+TEST_F(SentContentSettingRulesTrackerTest, UpdateVersion) {
+  content::MockRenderProcessHost process(browser_context());
+
+  EXPECT_TRUE(tracker()->UpdateVersion(&process, 1));
+  EXPECT_FALSE(tracker()->UpdateVersion(&process, 1));
+  EXPECT_TRUE(tracker()->UpdateVersion(&process, 2));
+  EXPECT_FALSE(tracker()->UpdateVersion(&process, 2));
+}
+
+TEST_F(SentContentSettingRulesTrackerTest, UpdateVersionPerProcess) {
+  content::MockRenderProcessHost process1(browser_context());
+  content::MockRenderProcessHost process2(browser_context());
+  ASSERT_NE(process1.GetID(), process2.GetID());
+
+  EXPECT_TRUE(tracker()->UpdateVersion(&process1, 1));
+  EXPECT_TRUE(tracker()->UpdateVersion(&process2, 1));
+  EXPECT_FALSE(tracker()->UpdateVersion(&process1, 1));
+  EXPECT_FALSE(tracker()->UpdateVersion(&process2, 1));
+}
+
+TEST_F(SentContentSettingRulesTrackerTest, ResendAfterProcessExit) {
+  content::MockRenderProcessHost process(browser_context());
+
+  EXPECT_TRUE(tracker()->UpdateVersion(&process, 1));
+  // A relaunched renderer reuses the RenderProcessHost and its ID, but has
+  // lost the rules.
+  process.SimulateCrash();
+  EXPECT_TRUE(tracker()->UpdateVersion(&process, 1));
+  EXPECT_FALSE(tracker()->UpdateVersion(&process, 1));
+}
+
+TEST_F(SentContentSettingRulesTrackerTest, ForgetDestroyedProcess) {
+  int id;
+  {
+    content::MockRenderProcessHost process(browser_context());
+    id = process.GetID();
+    EXPECT_TRUE(tracker()->UpdateVersion(&process, 1));
+    EXPECT_EQ(1u, tracker()->versions_.count(id));
+  }
+  EXPECT_EQ(0u, tracker()->versions_.count(id));
+}
+
+// Measures what is sent to renderers for a tab with 100 frames spread over
+// 10 processes while 10k content setting rules are set.
+TEST_F(SentContentSettingRulesTrackerTest, IPCSizeForManyRulesAndFrames) {
+  TestingProfile profile;
+  HostContentSettingsMap* map =
+      HostContentSettingsMapFactory::GetForProfile(&profile);
+  for (int i = 0; i < 10000; ++i) {
+    map->SetContentSettingCustomScope(
+        ContentSettingsPattern::FromString("[*.]site" +
+                                           base::NumberToString(i) + ".com"),
+        ContentSettingsPattern::Wildcard(), ContentSettingsType::JAVASCRIPT,
+        "", CONTENT_SETTING_BLOCK);
+  }
+
+  std::vector<std::unique_ptr<content::MockRenderProcessHost>> processes;
+  for (int i = 0; i < 10; ++i) {
+    processes.push_back(
+        std::make_unique<content::MockRenderProcessHost>(&profile));
+  }
+  std::vector<content::RenderProcessHost*> frame_processes;
+  for (int i = 0; i < 100; ++i)
+    frame_processes.push_back(processes[i % processes.size()].get());
+
+  size_t sent_messages = 0;
+  size_t sent_bytes = 0;
+  size_t rules_bytes = 0;
+  auto send = base::BindLambdaForTesting(
+      [&](content::RenderProcessHost* process,
+          const RendererContentSettingRules& rules) {
+        EXPECT_GE(rules.script_rules.size(), 10000u);
+        RendererContentSettingRules copy = rules;
+        rules_bytes =
+            content_settings::mojom::RendererContentSettingRules::Serialize(
+                &copy)
+                .size();
+        ++sent_messages;
+        sent_bytes += rules_bytes;
+      });
+
+  // Sending the rules for every frame would take 100 messages. Each process
+  // gets a single one instead.
+  uint64_t version = ContentSettingRulesVersion::Get(&profile);
+  tracker()->SendRulesIfNeeded(map, version, frame_processes, send);
+  EXPECT_EQ(10u, sent_messages);
+  EXPECT_EQ(10 * rules_bytes, sent_bytes);
+
+  // More frames created while nothing changed neither build nor send the
+  // rules again.
+  EXPECT_EQ(version, ContentSettingRulesVersion::Get(&profile));
+  tracker()->SendRulesIfNeeded(map, version, frame_processes, send);
+  EXPECT_EQ(10u, sent_messages);
+
+  // A changed setting is sent to every process once more.
+  map->SetContentSettingCustomScope(
+      ContentSettingsPattern::FromString("[*.]brave.com"),
+      ContentSettingsPattern::Wildcard(), ContentSettingsType::JAVASCRIPT, "",
+      CONTENT_SETTING_BLOCK);
+  EXPECT_NE(version, ContentSettingRulesVersion::Get(&profile));
+  version = ContentSettingRulesVersion::Get(&profile);
+  tracker()->SendRulesIfNeeded(map, version, frame_processes, send);
+  EXPECT_EQ(20u, sent_messages);
+  EXPECT_EQ(20 * rules_bytes, sent_bytes);
+}
+
+}  // namespace brave_shields
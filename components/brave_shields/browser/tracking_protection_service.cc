@@ -9,19 +9,19 @@
 
 #include "base/bind.h"
 #include "base/command_line.h"
-#include "base/task/post_task.h"
-#include "base/task_runner_util.h"
 #include "brave/common/brave_switches.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
-#include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 
 #if BUILDFLAG(BRAVE_STP_ENABLED)
+#include "base/hash/hash.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/tracking_protection_helper.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #endif
 
 using content::BrowserThread;
@@ -31,13 +31,29 @@ namespace brave_shields {
 #if BUILDFLAG(BRAVE_STP_ENABLED)
 const char kDatFileVersion[] = "1";
 const char kStorageTrackersFile[] = "StorageTrackingProtection.dat";
+// Starting sites are kept per main frame, so this is far above the number of
+// live main frames in any realistic session.
+const size_t kMaxStartingSites = 1024;
+
+namespace {
+
+TrackingProtectionService::StorageTrackers LoadStorageTrackers(
+    const base::FilePath& path) {
+  return TrackingProtectionService::ParseStorageTrackers(
+      brave_component_updater::GetDATFileAsString(path));
+}
+
+}  // namespace
 #endif
 
 TrackingProtectionService::TrackingProtectionService(
     LocalDataFilesService* local_data_files_service)
-    : LocalDataFilesObserver(local_data_files_service),
-      weak_factory_(this),
-      weak_factory_io_thread_(this) {
+    : LocalDataFilesObserver(local_data_files_service,
+                             base::TaskPriority::USER_BLOCKING),
+#if BUILDFLAG(BRAVE_STP_ENABLED)
+      render_frame_key_to_starting_site_url_(kMaxStartingSites),
+#endif
+      weak_factory_(this) {
 }
 
 TrackingProtectionService::~TrackingProtectionService() {
@@ -64,25 +80,36 @@ TrackingProtectionService::RenderFrameIdKey::RenderFrameIdKey(
     : render_process_id(render_process_id),
       frame_routing_id(frame_routing_id) {}
 
-bool TrackingProtectionService::RenderFrameIdKey::operator<(
-    const RenderFrameIdKey& other) const {
-  return std::tie(render_process_id, frame_routing_id) <
-         std::tie(other.render_process_id, other.frame_routing_id);
-}
-
 bool TrackingProtectionService::RenderFrameIdKey::operator==(
     const RenderFrameIdKey& other) const {
   return render_process_id == other.render_process_id &&
          frame_routing_id == other.frame_routing_id;
 }
 
+size_t TrackingProtectionService::RenderFrameIdKeyHash::operator()(
+    const RenderFrameIdKey& key) const {
+  return base::HashInts(key.render_process_id, key.frame_routing_id);
+}
+
+// static
+TrackingProtectionService::StorageTrackers
+TrackingProtectionService::ParseStorageTrackers(base::StringPiece contents) {
+  StorageTrackers storage_trackers;
+  for (base::StringPiece tracker :
+       base::SplitStringPiece(contents, ",", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    storage_trackers.insert(base::ToLowerASCII(tracker));
+  }
+  return storage_trackers;
+}
+
 void TrackingProtectionService::SetStartingSiteForRenderFrame(
     GURL starting_site,
     int render_process_id,
     int render_frame_id) {
-  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
   const RenderFrameIdKey key(render_process_id, render_frame_id);
-  render_frame_key_to_starting_site_url[key] = starting_site;
+  render_frame_key_to_starting_site_url_.Put(key, std::move(starting_site));
 }
 
 GURL TrackingProtectionService::GetStartingSiteForRenderFrame(
@@ -90,8 +117,8 @@ GURL TrackingProtectionService::GetStartingSiteForRenderFrame(
     int render_frame_id) const {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
   const RenderFrameIdKey key(render_process_id, render_frame_id);
-  auto iter = render_frame_key_to_starting_site_url.find(key);
-  if (iter != render_frame_key_to_starting_site_url.end()) {
+  auto iter = render_frame_key_to_starting_site_url_.Peek(key);
+  if (iter != render_frame_key_to_starting_site_url_.end()) {
     return iter->second;
   }
   return {};
@@ -101,22 +128,25 @@ void TrackingProtectionService::ModifyRenderFrameKey(int old_render_process_id,
                                                      int old_render_frame_id,
                                                      int new_render_process_id,
                                                      int new_render_frame_id) {
-  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
   const RenderFrameIdKey old_key(old_render_process_id, old_render_frame_id);
-  auto iter = render_frame_key_to_starting_site_url.find(old_key);
-  if (iter != render_frame_key_to_starting_site_url.end()) {
+  auto iter = render_frame_key_to_starting_site_url_.Peek(old_key);
+  if (iter != render_frame_key_to_starting_site_url_.end()) {
+    GURL starting_site = std::move(iter->second);
+    render_frame_key_to_starting_site_url_.Erase(iter);
     const RenderFrameIdKey new_key(new_render_process_id, new_render_frame_id);
-    render_frame_key_to_starting_site_url.insert(
-        std::pair<RenderFrameIdKey, GURL>(new_key, iter->second));
-    render_frame_key_to_starting_site_url.erase(old_key);
+    render_frame_key_to_starting_site_url_.Put(new_key,
+                                               std::move(starting_site));
   }
 }
 
 void TrackingProtectionService::DeleteRenderFrameKey(int render_process_id,
                                                      int render_frame_id) {
-  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
   const RenderFrameIdKey key(render_process_id, render_frame_id);
-  render_frame_key_to_starting_site_url.erase(key);
+  auto iter = render_frame_key_to_starting_site_url_.Peek(key);
+  if (iter != render_frame_key_to_starting_site_url_.end())
+    render_frame_key_to_starting_site_url_.Erase(iter);
 }
 
 bool TrackingProtectionService::ShouldStoreState(HostContentSettingsMap* map,
@@ -153,36 +183,30 @@ bool TrackingProtectionService::ShouldStoreState(HostContentSettingsMap* map,
     return true;
 
   // deny storage if host is found in the tracker list
-  return first_party_storage_trackers_.find(host) ==
-         first_party_storage_trackers_.end();
+  return !IsStorageTracker(host);
 }
 
-void TrackingProtectionService::OnGetSTPDATFileData(std::string contents) {
-  if (contents.empty()) {
-    LOG(ERROR) << "Could not obtain first party trackers data";
-    return;
-  }
+bool TrackingProtectionService::IsStorageTracker(
+    const std::string& host) const {
+  if (first_party_storage_trackers_.count(host))
+    return true;
 
-  std::vector<std::string> storage_trackers =
-      base::SplitString(base::StringPiece(contents.data(), contents.size()),
-                        ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  const std::string domain =
+      net::registry_controlled_domains::GetDomainAndRegistry(
+          host, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  return !domain.empty() && domain != host &&
+         first_party_storage_trackers_.count(domain);
+}
 
+void TrackingProtectionService::OnGetStorageTrackers(
+    StorageTrackers storage_trackers) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
   if (storage_trackers.empty()) {
     LOG(ERROR) << "No first party trackers found";
     return;
   }
 
-  base::PostTask(
-      FROM_HERE, {BrowserThread::IO},
-      base::BindOnce(
-          &TrackingProtectionService::UpdateFirstPartyStorageTrackers,
-          weak_factory_io_thread_.GetWeakPtr(), std::move(storage_trackers)));
-}
-
-void TrackingProtectionService::UpdateFirstPartyStorageTrackers(
-    std::vector<std::string> storage_trackers) {
-  first_party_storage_trackers_ =
-      base::flat_set<std::string>(std::move(storage_trackers));
+  first_party_storage_trackers_ = std::move(storage_trackers);
 }
 
 #else  // !BUILDFLAG(BRAVE_STP_ENABLED)
@@ -222,13 +246,11 @@ void TrackingProtectionService::OnComponentReady(
       .AppendASCII(kDatFileVersion)
       .AppendASCII(kStorageTrackersFile);
 
-  base::PostTaskAndReplyWithResult(
-      local_data_files_service()->GetTaskRunner().get(),
-      FROM_HERE,
-      base::BindOnce(&brave_component_updater::GetDATFileAsString,
-                     storage_tracking_protection_path),
-      base::BindOnce(&TrackingProtectionService::OnGetSTPDATFileData,
-                     weak_factory_.GetWeakPtr()));
+  LoadData("StorageTrackingProtection",
+           base::BindOnce(&LoadStorageTrackers,
+                          storage_tracking_protection_path),
+           base::BindOnce(&TrackingProtectionService::OnGetStorageTrackers,
+                          weak_factory_.GetWeakPtr()));
 #endif
 }
 
@@ -9,13 +9,15 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
-#include "base/containers/flat_set.h"
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequenced_task_runner.h"
+#include "base/strings/string_piece.h"
 #include "base/synchronization/lock.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_observer.h"
@@ -25,6 +27,7 @@
 
 class HostContentSettingsMap;
 class TrackingProtectionServiceTest;
+class TrackingProtectionServiceUnitTest;
 
 using brave_component_updater::LocalDataFilesObserver;
 using brave_component_updater::LocalDataFilesService;
@@ -34,6 +37,14 @@ namespace brave_shields {
 // The brave shields service in charge of tracking protection and init.
 class TrackingProtectionService : public LocalDataFilesObserver {
  public:
+#if BUILDFLAG(BRAVE_STP_ENABLED)
+  using StorageTrackers = std::unordered_set<std::string>;
+
+  // Parses the comma separated storage trackers list provided by the
+  // offline-crawler.
+  static StorageTrackers ParseStorageTrackers(base::StringPiece contents);
+#endif
+
   explicit TrackingProtectionService(
       LocalDataFilesService* local_data_files_service);
   ~TrackingProtectionService() override;
@@ -61,6 +72,8 @@ class TrackingProtectionService : public LocalDataFilesObserver {
                         const GURL& origin_url) const;
 
 #if BUILDFLAG(BRAVE_STP_ENABLED)
+  // The starting site map is only touched on the UI thread, where storage
+  // access is decided.
   void SetStartingSiteForRenderFrame(GURL starting_site,
                                      int render_process_id,
                                      int render_frame_id);
@@ -76,10 +89,10 @@ class TrackingProtectionService : public LocalDataFilesObserver {
 
  protected:
 #if BUILDFLAG(BRAVE_STP_ENABLED)
-  // ParseStorageTrackersData parses the storage trackers list provided by
-  // the offline-crawler
-  void OnGetSTPDATFileData(std::string contents);
-  void UpdateFirstPartyStorageTrackers(std::vector<std::string>);
+  // Returns true if |host|, or the registrable domain it belongs to, is in
+  // the storage trackers list.
+  bool IsStorageTracker(const std::string& host) const;
+  void OnGetStorageTrackers(StorageTrackers storage_trackers);
 
   // For Smart Tracking Protection, we need to keep track of the starting site
   // that initiated the redirects. We use RenderFrameIdKey to determine the
@@ -91,15 +104,23 @@ class TrackingProtectionService : public LocalDataFilesObserver {
     int render_process_id;
     int frame_routing_id;
 
-    bool operator<(const RenderFrameIdKey& other) const;
     bool operator==(const RenderFrameIdKey& other) const;
   };
+
+  struct RenderFrameIdKeyHash {
+    size_t operator()(const RenderFrameIdKey& key) const;
+  };
 #endif
 
  private:
+  friend class ::TrackingProtectionServiceUnitTest;
+
 #if BUILDFLAG(BRAVE_STP_ENABLED)
-  base::flat_set<std::string> first_party_storage_trackers_;
-  std::map<RenderFrameIdKey, GURL> render_frame_key_to_starting_site_url;
+  StorageTrackers first_party_storage_trackers_;
+  // Entries are removed when their frame goes away, the size cap only guards
+  // against frames whose deletion we never hear about.
+  base::HashingMRUCache<RenderFrameIdKey, GURL, RenderFrameIdKeyHash>
+      render_frame_key_to_starting_site_url_;
 #endif
 
   std::vector<std::string> third_party_base_hosts_;
@@ -107,7 +128,6 @@ class TrackingProtectionService : public LocalDataFilesObserver {
   base::Lock third_party_hosts_lock_;
 
   base::WeakPtrFactory<TrackingProtectionService> weak_factory_;
-  base::WeakPtrFactory<TrackingProtectionService> weak_factory_io_thread_;
   DISALLOW_COPY_AND_ASSIGN(TrackingProtectionService);
 };
 
@@ -0,0 +1,104 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/tracking_protection_service.h"
+
+#include <string>
+
+#include "brave/components/brave_component_updater/browser/local_data_files_service.h"
+#include "brave/components/brave_component_updater/browser/test_util.h"
+#include "brave/components/brave_shields/browser/buildflags/buildflags.h"  // For STP
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#if BUILDFLAG(BRAVE_STP_ENABLED)
+
+using brave_component_updater::TestComponentDelegate;
+using brave_shields::TrackingProtectionService;
+
+class TrackingProtectionServiceUnitTest : public testing::Test {
+ public:
+  TrackingProtectionServiceUnitTest()
+      : local_data_files_service_(&delegate_),
+        service_(&local_data_files_service_) {}
+
+ protected:
+  size_t starting_site_count() const {
+    return service_.render_frame_key_to_starting_site_url_.size();
+  }
+
+  bool IsStorageTracker(const std::string& host) const {
+    return service_.IsStorageTracker(host);
+  }
+
+  void SetStorageTrackers(const std::string& contents) {
+    service_.OnGetStorageTrackers(
+        TrackingProtectionService::ParseStorageTrackers(contents));
+  }
+
+  content::BrowserTaskEnvironment task_environment_;
+  TestComponentDelegate delegate_;
+  LocalDataFilesService local_data_files_service_;
+  TrackingProtectionService service_;
+};
+
+TEST_F(TrackingProtectionServiceUnitTest, ParseStorageTrackers) {
+  TrackingProtectionService::StorageTrackers trackers =
+      TrackingProtectionService::ParseStorageTrackers(
+          "tracker.com,, t.com ,\nTracker.co.uk,");
+  EXPECT_EQ(3u, trackers.size());
+  EXPECT_EQ(1u, trackers.count("tracker.com"));
+  EXPECT_EQ(1u, trackers.count("t.com"));
+  EXPECT_EQ(1u, trackers.count("tracker.co.uk"));
+}
+
+TEST_F(TrackingProtectionServiceUnitTest, MatchesRegistrableDomain) {
+  SetStorageTrackers("tracker.com,sub.example.com");
+
+  EXPECT_TRUE(IsStorageTracker("tracker.com"));
+  EXPECT_TRUE(IsStorageTracker("www.tracker.com"));
+  EXPECT_TRUE(IsStorageTracker("sub.example.com"));
+  EXPECT_FALSE(IsStorageTracker("example.com"));
+  EXPECT_FALSE(IsStorageTracker("other.example.com"));
+  EXPECT_FALSE(IsStorageTracker("nottracker.com"));
+}
+
+TEST_F(TrackingProtectionServiceUnitTest, StartingSitesFollowFrames) {
+  const GURL url("https://example.com/");
+  service_.SetStartingSiteForRenderFrame(url, 1, 1);
+  EXPECT_EQ(url, service_.GetStartingSiteForRenderFrame(1, 1));
+
+  service_.ModifyRenderFrameKey(1, 1, 2, 5);
+  EXPECT_EQ(GURL(), service_.GetStartingSiteForRenderFrame(1, 1));
+  EXPECT_EQ(url, service_.GetStartingSiteForRenderFrame(2, 5));
+
+  service_.DeleteRenderFrameKey(2, 5);
+  EXPECT_EQ(GURL(), service_.GetStartingSiteForRenderFrame(2, 5));
+  EXPECT_EQ(0u, starting_site_count());
+}
+
+TEST_F(TrackingProtectionServiceUnitTest, StartingSitesStayBounded) {
+  // Thousands of navigations whose frames are cleaned up leave nothing
+  // behind.
+  for (int i = 0; i < 5000; ++i) {
+    service_.SetStartingSiteForRenderFrame(
+        GURL("https://site" + std::to_string(i) + ".com/"), i % 50, i);
+    service_.DeleteRenderFrameKey(i % 50, i);
+  }
+  EXPECT_EQ(0u, starting_site_count());
+
+  // Frames whose deletion is never observed can't grow the map without
+  // bound, and the most recent ones are kept.
+  for (int i = 0; i < 5000; ++i) {
+    service_.SetStartingSiteForRenderFrame(
+        GURL("https://site" + std::to_string(i) + ".com/"), i % 50, i);
+  }
+  EXPECT_LE(starting_site_count(), 1024u);
+  EXPECT_EQ(GURL("https://site4999.com/"),
+            service_.GetStartingSiteForRenderFrame(4999 % 50, 4999));
+  EXPECT_EQ(GURL(), service_.GetStartingSiteForRenderFrame(0, 0));
+}
+
+#endif  // BUILDFLAG(BRAVE_STP_ENABLED)
@@ -14,5 +14,18 @@ const base::Feature kBraveAdblockCosmeticFiltering{
     "BraveAdblockCosmeticFiltering",
     base::FEATURE_ENABLED_BY_DEFAULT};
 
+const base::Feature kBraveHTTPSEverywhereCache{
+    "BraveHTTPSEverywhereCache",
+    base::FEATURE_ENABLED_BY_DEFAULT};
+
+const base::FeatureParam<int> kHTTPSEverywhereRewriteCacheSize{
+    &kBraveHTTPSEverywhereCache, "rewrite_cache_size", 1000};
+
+const base::FeatureParam<int> kHTTPSEverywhereNoRuleCacheSize{
+    &kBraveHTTPSEverywhereCache, "no_rule_cache_size", 4000};
+
+const base::FeatureParam<int> kHTTPSEverywhereCacheShards{
+    &kBraveHTTPSEverywhereCache, "cache_shards", 8};
+
 }  // namespace features
 }  // namespace brave_shields
@@ -6,6 +6,8 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_COMMON_FEATURES_H_
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_COMMON_FEATURES_H_
 
+#include "base/metrics/field_trial_params.h"
+
 namespace base {
 struct Feature;
 }  // namespace base
@@ -13,6 +15,13 @@ struct Feature;
 namespace brave_shields {
 namespace features {
 extern const base::Feature kBraveAdblockCosmeticFiltering;
+extern const base::Feature kBraveHTTPSEverywhereCache;
+// Number of URLs with a known HTTPS rewrite kept in memory.
+extern const base::FeatureParam<int> kHTTPSEverywhereRewriteCacheSize;
+// Number of hosts known to have no HTTPS Everywhere rule kept in memory.
+extern const base::FeatureParam<int> kHTTPSEverywhereNoRuleCacheSize;
+// Number of independently locked shards each cache is split into.
+extern const base::FeatureParam<int> kHTTPSEverywhereCacheShards;
 }  // namespace features
 }  // namespace brave_shields
 
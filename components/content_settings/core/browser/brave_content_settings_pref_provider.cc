@@ -5,6 +5,7 @@
 
 #include "brave/components/content_settings/core/browser/brave_content_settings_pref_provider.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -45,56 +46,112 @@ Rule CloneRule(const Rule& rule, bool reverse_patterns = false) {
               rule.value.Clone());
 }
 
-class BraveShieldsRuleIterator : public RuleIterator {
+Rule ToBraveCookieRule(const ContentSettingsPattern& primary_pattern,
+                       const ContentSettingsPattern& secondary_pattern,
+                       const base::Value& value) {
+  return CloneRule(Rule(primary_pattern, secondary_pattern, value.Clone()),
+                   true);
+}
+
+}  // namespace
+
+// Iterates over the cookie rules derived from |rules| in the order they take
+// precedence in: the google login rule, chromium cookie settings, brave cookie
+// settings of sites with shields up and finally rules allowing cookies for
+// sites with shields down.
+class BravePrefProvider::CookieRuleIterator : public RuleIterator {
  public:
-  BraveShieldsRuleIterator(std::vector<Rule>::const_iterator iterator,
-                           std::vector<Rule>::const_iterator end)
-      : iterator_(iterator),
-        end_(end) {}
+  CookieRuleIterator(const Rule* google_login_rule,
+                     const CookieRules& rules,
+                     bool include_chromium_rules)
+      : google_login_rule_(google_login_rule),
+        chromium_iterator_(include_chromium_rules ?
+                           rules.chromium_rules.begin() :
+                           rules.chromium_rules.end()),
+        chromium_end_(rules.chromium_rules.end()),
+        brave_cookie_iterator_(rules.brave_cookie_rules.begin()),
+        brave_cookie_end_(rules.brave_cookie_rules.end()),
+        shield_iterator_(rules.shield_rules.begin()),
+        shield_end_(rules.shield_rules.end()) {
+    SkipInactiveRules();
+  }
 
   bool HasNext() const override {
-    return iterator_ != end_;
+    return google_login_rule_ ||
+           chromium_iterator_ != chromium_end_ ||
+           brave_cookie_iterator_ != brave_cookie_end_ ||
+           shield_iterator_ != shield_end_;
   }
 
   Rule Next() override {
-    return CloneRule(*(iterator_++));
+    if (google_login_rule_) {
+      auto rule = CloneRule(*google_login_rule_);
+      google_login_rule_ = nullptr;
+      return rule;
+    }
+
+    if (chromium_iterator_ != chromium_end_)
+      return CloneRule(*(chromium_iterator_++));
+
+    if (brave_cookie_iterator_ != brave_cookie_end_) {
+      auto rule = CloneRule((brave_cookie_iterator_++)->second.rule);
+      SkipInactiveRules();
+      return rule;
+    }
+
+    // Shields down.
+    DCHECK(shield_iterator_ != shield_end_);
+    auto rule = Rule(ContentSettingsPattern::Wildcard(),
+                     (shield_iterator_++)->first.first,
+                     ContentSettingToValue(CONTENT_SETTING_ALLOW)->Clone());
+    SkipInactiveRules();
+    return rule;
   }
 
  private:
-  std::vector<Rule>::const_iterator iterator_;
-  std::vector<Rule>::const_iterator end_;
+  void SkipInactiveRules() {
+    while (brave_cookie_iterator_ != brave_cookie_end_ &&
+           !brave_cookie_iterator_->second.active) {
+      ++brave_cookie_iterator_;
+    }
+    while (shield_iterator_ != shield_end_ &&
+           ValueToContentSetting(&shield_iterator_->second) !=
+              CONTENT_SETTING_BLOCK) {
+      ++shield_iterator_;
+    }
+  }
+
+  const Rule* google_login_rule_;
+  std::vector<Rule>::const_iterator chromium_iterator_;
+  std::vector<Rule>::const_iterator chromium_end_;
+  BraveCookieRuleMap::const_iterator brave_cookie_iterator_;
+  BraveCookieRuleMap::const_iterator brave_cookie_end_;
+  RuleMap::const_iterator shield_iterator_;
+  RuleMap::const_iterator shield_end_;
 
-  DISALLOW_COPY_AND_ASSIGN(BraveShieldsRuleIterator);
+  DISALLOW_COPY_AND_ASSIGN(CookieRuleIterator);
 };
 
+BravePrefProvider::BraveCookieRule::BraveCookieRule(Rule rule, bool active)
+    : rule(std::move(rule)), active(active) {}
 
-bool IsActive(const Rule& cookie_rule,
-              const std::vector<Rule>& shield_rules) {
-  // don't include default rules in the iterator
-  if (cookie_rule.primary_pattern == ContentSettingsPattern::Wildcard() &&
-      (cookie_rule.secondary_pattern == ContentSettingsPattern::Wildcard() ||
-       cookie_rule.secondary_pattern ==
-          ContentSettingsPattern::FromString("https://firstParty/*"))) {
-    return false;
-  }
+BravePrefProvider::BraveCookieRule::BraveCookieRule(BraveCookieRule&& other) =
+    default;
 
-  bool default_value = true;
-  for (const auto& shield_rule : shield_rules) {
-    auto primary_compare =
-        shield_rule.primary_pattern.Compare(cookie_rule.primary_pattern);
-    // TODO(bridiver) - verify that SUCCESSOR is correct and not PREDECESSOR
-    if (primary_compare == ContentSettingsPattern::IDENTITY ||
-        primary_compare == ContentSettingsPattern::SUCCESSOR) {
-      // TODO(bridiver) - move this logic into shields_util for allow/block
-      return
-          ValueToContentSetting(&shield_rule.value) != CONTENT_SETTING_BLOCK;
-    }
-  }
+BravePrefProvider::BraveCookieRule&
+BravePrefProvider::BraveCookieRule::operator=(BraveCookieRule&& other) =
+    default;
 
-  return default_value;
-}
+BravePrefProvider::BraveCookieRule::~BraveCookieRule() = default;
 
-}  // namespace
+BravePrefProvider::CookieRules::CookieRules() = default;
+
+BravePrefProvider::CookieRules::CookieRules(CookieRules&& other) = default;
+
+BravePrefProvider::CookieRules& BravePrefProvider::CookieRules::operator=(
+    CookieRules&& other) = default;
+
+BravePrefProvider::CookieRules::~CookieRules() = default;
 
 BravePrefProvider::BravePrefProvider(PrefService* prefs,
                                      bool off_the_record,
@@ -125,7 +182,12 @@ BravePrefProvider::BravePrefProvider(PrefService* prefs,
   MigrateShieldsSettings(off_the_record);
 
   AddObserver(this);
-  OnCookieSettingsChanged(ContentSettingsType::PLUGINS);
+
+  // Nothing observes this provider yet, so there is nothing to notify.
+  std::vector<PatternPair> changes;
+  UpdateGoogleLoginRule(&changes);
+  RebuildCookieRules(true);
+  RebuildCookieRules(false);
 }
 
 BravePrefProvider::~BravePrefProvider() {}
@@ -229,16 +291,19 @@ bool BravePrefProvider::SetWebsiteSetting(
 
   // handle changes to brave cookie settings from chromium cookie settings UI
   if (content_type == ContentSettingsType::COOKIES) {
-    auto* value = in_value.get();
-    auto match = std::find_if(
-        brave_cookie_rules_[off_the_record_].begin(),
-        brave_cookie_rules_[off_the_record_].end(),
-        [primary_pattern, secondary_pattern, value](const auto& rule) {
-          return rule.primary_pattern == primary_pattern &&
-                 rule.secondary_pattern == secondary_pattern &&
-                 ValueToContentSetting(&rule.value) !=
-                    ValueToContentSetting(value); });
-    if (match != brave_cookie_rules_[off_the_record_].end()) {
+    bool match = false;
+    CookieRuleIterator brave_cookie_rules(
+        google_login_rule_ ? &google_login_rule_.value() : nullptr,
+        cookie_rules_[off_the_record_],
+        false /* include_chromium_rules */);
+    while (!match && brave_cookie_rules.HasNext()) {
+      auto rule = brave_cookie_rules.Next();
+      match = rule.primary_pattern == primary_pattern &&
+              rule.secondary_pattern == secondary_pattern &&
+              ValueToContentSetting(&rule.value) !=
+                  ValueToContentSetting(in_value.get());
+    }
+    if (match) {
       // swap primary/secondary pattern - see CloneRule
       auto plugin_primary_pattern = secondary_pattern;
       auto plugin_secondary_pattern = primary_pattern;
@@ -268,9 +333,10 @@ std::unique_ptr<RuleIterator> BravePrefProvider::GetRuleIterator(
       const ResourceIdentifier& resource_identifier,
       bool incognito) const {
   if (content_type == ContentSettingsType::COOKIES) {
-    return std::make_unique<BraveShieldsRuleIterator>(
-        cookie_rules_.at(incognito).begin(),
-        cookie_rules_.at(incognito).end());
+    return std::make_unique<CookieRuleIterator>(
+        google_login_rule_ ? &google_login_rule_.value() : nullptr,
+        cookie_rules_.at(incognito),
+        true /* include_chromium_rules */);
   }
 
   // Early return. We don't store flash plugin setting in preference.
@@ -283,28 +349,106 @@ std::unique_ptr<RuleIterator> BravePrefProvider::GetRuleIterator(
                                        incognito);
 }
 
-void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
-                                          bool incognito) {
-  auto& rules = cookie_rules_[incognito];
-  auto old_rules = std::move(brave_cookie_rules_[incognito]);
+// static
+bool BravePrefProvider::IsActive(const PatternPair& cookie_patterns,
+                                 const RuleMap& shield_rules) {
+  // don't include default rules in the iterator
+  if (cookie_patterns.first == ContentSettingsPattern::Wildcard() &&
+      (cookie_patterns.second == ContentSettingsPattern::Wildcard() ||
+       cookie_patterns.second ==
+          ContentSettingsPattern::FromString("https://firstParty/*"))) {
+    return false;
+  }
 
-  rules.clear();
+  bool default_value = true;
+  for (const auto& shield_rule : shield_rules) {
+    auto primary_compare =
+        shield_rule.first.first.Compare(cookie_patterns.first);
+    // TODO(bridiver) - verify that SUCCESSOR is correct and not PREDECESSOR
+    if (primary_compare == ContentSettingsPattern::IDENTITY ||
+        primary_compare == ContentSettingsPattern::SUCCESSOR) {
+      // TODO(bridiver) - move this logic into shields_util for allow/block
+      return
+          ValueToContentSetting(&shield_rule.second) != CONTENT_SETTING_BLOCK;
+    }
+  }
+
+  return default_value;
+}
+
+BravePrefProvider::RuleMap BravePrefProvider::GetRuleMap(
+    ContentSettingsType content_type,
+    const std::string& resource_identifier,
+    bool incognito) const {
+  RuleMap rules;
+  auto iterator = PrefProvider::GetRuleIterator(content_type,
+                                                resource_identifier,
+                                                incognito);
+  while (iterator && iterator->HasNext()) {
+    auto rule = iterator->Next();
+    rules.emplace(PatternPair(rule.primary_pattern, rule.secondary_pattern),
+                  std::move(rule.value));
+  }
+  return rules;
+}
+
+void BravePrefProvider::RebuildCookieRules(bool incognito) {
+  CookieRules rules;
+  rules.shield_rules = GetRuleMap(ContentSettingsType::PLUGINS,
+                                  brave_shields::kBraveShields,
+                                  incognito);
+  // There is no global shields rule
+  for (const auto& shield_rule : rules.shield_rules)
+    DCHECK(!shield_rule.first.first.MatchesAllHosts());
+
+  // Matching cookie rules against shield rules.
+  auto cookie_settings = GetRuleMap(ContentSettingsType::PLUGINS,
+                                    brave_shields::kCookies,
+                                    incognito);
+  for (const auto& cookie_setting : cookie_settings) {
+    rules.brave_cookie_rules.emplace(
+        cookie_setting.first,
+        BraveCookieRule(ToBraveCookieRule(cookie_setting.first.first,
+                                          cookie_setting.first.second,
+                                          cookie_setting.second),
+                        IsActive(cookie_setting.first, rules.shield_rules)));
+  }
 
+  cookie_rules_[incognito] = std::move(rules);
+  UpdateChromiumCookieRules(incognito);
+}
+
+void BravePrefProvider::UpdateGoogleLoginRule(
+    std::vector<PatternPair>* changes) {
   // kGoogleLoginControlType preference adds an exception for
   // accounts.google.com to access cookies in 3p context to allow login using
   // google oauth. The exception is added before all overrides to allow google
   // oauth to work when the user sets custom overrides for a site.
   // For example: Google OAuth will be allowed if the user allows all cookies
   // and sets 3p cookie blocking for a site.
-  if (prefs_->GetBoolean(kGoogleLoginControlType)) {
-      auto rule = Rule(ContentSettingsPattern::FromString(kGoogleOAuthPattern),
-                       ContentSettingsPattern::Wildcard(),
-                       ContentSettingToValue(CONTENT_SETTING_ALLOW)->Clone());
-      rules.push_back(CloneRule(rule));
-      brave_cookie_rules_[incognito].push_back(CloneRule(rule));
+  const bool allow_google_login =
+      prefs_->GetBoolean(kGoogleLoginControlType);
+  if (allow_google_login == google_login_rule_.has_value())
+    return;
+
+  const auto google_oauth_pattern =
+      ContentSettingsPattern::FromString(kGoogleOAuthPattern);
+  if (allow_google_login) {
+    google_login_rule_.emplace(
+        google_oauth_pattern,
+        ContentSettingsPattern::Wildcard(),
+        ContentSettingToValue(CONTENT_SETTING_ALLOW)->Clone());
+  } else {
+    google_login_rule_.reset();
   }
+  changes->emplace_back(google_oauth_pattern,
+                        ContentSettingsPattern::Wildcard());
+}
+
+void BravePrefProvider::UpdateChromiumCookieRules(bool incognito) {
+  auto& rules = cookie_rules_[incognito].chromium_rules;
+  rules.clear();
 
-  // add chromium cookies
   auto chromium_cookies_iterator = PrefProvider::GetRuleIterator(
       ContentSettingsType::COOKIES,
       "",
@@ -312,110 +456,130 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
   while (chromium_cookies_iterator && chromium_cookies_iterator->HasNext()) {
     rules.push_back(CloneRule(chromium_cookies_iterator->Next()));
   }
-  chromium_cookies_iterator.reset();
+}
 
-  auto brave_shields_iterator = PrefProvider::GetRuleIterator(
-      ContentSettingsType::PLUGINS,
-      brave_shields::kBraveShields,
-      incognito);
+void BravePrefProvider::UpdateShieldRules(bool incognito,
+                                          std::vector<PatternPair>* changes) {
+  auto& rules = cookie_rules_[incognito];
+  auto shield_rules = GetRuleMap(ContentSettingsType::PLUGINS,
+                                 brave_shields::kBraveShields,
+                                 incognito);
 
-  // collect shield rules
-  std::vector<Rule> shield_rules;
-  while (brave_shields_iterator && brave_shields_iterator->HasNext()) {
-    shield_rules.push_back(CloneRule(brave_shields_iterator->Next()));
+  // Find the sites whose shields setting was added, changed or removed.
+  std::vector<ContentSettingsPattern> changed_patterns;
+  for (const auto& shield_rule : shield_rules) {
+    auto old_rule = rules.shield_rules.find(shield_rule.first);
+    if (old_rule == rules.shield_rules.end() ||
+        old_rule->second != shield_rule.second) {
+      changed_patterns.push_back(shield_rule.first.first);
+    }
+  }
+  for (const auto& old_rule : rules.shield_rules) {
+    if (shield_rules.find(old_rule.first) == shield_rules.end())
+      changed_patterns.push_back(old_rule.first.first);
   }
 
-  brave_shields_iterator.reset();
+  rules.shield_rules = std::move(shield_rules);
 
-  // add brave cookies after checking shield status
-  auto brave_cookies_iterator = PrefProvider::GetRuleIterator(
-      ContentSettingsType::PLUGINS,
-      brave_shields::kCookies,
-      incognito);
+  for (const auto& pattern : changed_patterns) {
+    // There is no global shields rule
+    DCHECK(!pattern.MatchesAllHosts());
+
+    // The shields down rule for the site.
+    changes->emplace_back(ContentSettingsPattern::Wildcard(), pattern);
+
+    // Only the brave cookie settings the site's shields setting applies to
+    // can change.
+    for (auto& brave_cookie_rule : rules.brave_cookie_rules) {
+      auto primary_compare = pattern.Compare(brave_cookie_rule.first.first);
+      if (primary_compare != ContentSettingsPattern::IDENTITY &&
+          primary_compare != ContentSettingsPattern::SUCCESSOR) {
+        continue;
+      }
 
-  // Matching cookie rules against shield rules.
-  while (brave_cookies_iterator && brave_cookies_iterator->HasNext()) {
-    auto rule = brave_cookies_iterator->Next();
-    if (IsActive(rule, shield_rules)) {
-      rules.push_back(CloneRule(rule, true));
-      brave_cookie_rules_[incognito].push_back(CloneRule(rule, true));
+      const bool active =
+          IsActive(brave_cookie_rule.first, rules.shield_rules);
+      if (active == brave_cookie_rule.second.active)
+        continue;
+
+      brave_cookie_rule.second.active = active;
+      changes->emplace_back(brave_cookie_rule.second.rule.primary_pattern,
+                            brave_cookie_rule.second.rule.secondary_pattern);
     }
   }
+}
 
-  // Adding shields down rules (they always override cookie rules).
-  for (const auto& shield_rule : shield_rules) {
-    // There is no global shields rule
-    if (shield_rule.primary_pattern.MatchesAllHosts())
-      NOTREACHED();
+void BravePrefProvider::UpdateBraveCookieRules(
+    bool incognito,
+    std::vector<PatternPair>* changes) {
+  auto& rules = cookie_rules_[incognito];
+  auto cookie_settings = GetRuleMap(ContentSettingsType::PLUGINS,
+                                    brave_shields::kCookies,
+                                    incognito);
 
-    // Shields down.
-    if (ValueToContentSetting(&shield_rule.value) == CONTENT_SETTING_BLOCK) {
-      rules.push_back(
-          Rule(ContentSettingsPattern::Wildcard(),
-               shield_rule.primary_pattern,
-               ContentSettingToValue(CONTENT_SETTING_ALLOW)->Clone()));
-      brave_cookie_rules_[incognito].push_back(
-          Rule(ContentSettingsPattern::Wildcard(),
-               shield_rule.primary_pattern,
-               ContentSettingToValue(CONTENT_SETTING_ALLOW)->Clone()));
+  // find any removed rules
+  for (auto it = rules.brave_cookie_rules.begin();
+       it != rules.brave_cookie_rules.end();) {
+    if (cookie_settings.find(it->first) != cookie_settings.end()) {
+      ++it;
+      continue;
+    }
+    if (it->second.active) {
+      changes->emplace_back(it->second.rule.primary_pattern,
+                            it->second.rule.secondary_pattern);
     }
+    it = rules.brave_cookie_rules.erase(it);
   }
 
-  // get the list of changes
-  std::vector<Rule> brave_cookie_updates;
-  for (const auto& new_rule : brave_cookie_rules_[incognito]) {
-    auto match = std::find_if(
-        old_rules.begin(),
-        old_rules.end(),
-        [&new_rule](const auto& old_rule) {
-          // we want an exact match here because any change to the rule
-          // is an update
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern &&
-                 ValueToContentSetting(&new_rule.value) ==
-                    ValueToContentSetting(&old_rule.value);
-        });
-    if (match == old_rules.end()) {
-      brave_cookie_updates.push_back(CloneRule(new_rule));
+  // Only match added or changed cookie rules against shield rules.
+  for (const auto& cookie_setting : cookie_settings) {
+    auto old_rule = rules.brave_cookie_rules.find(cookie_setting.first);
+    if (old_rule != rules.brave_cookie_rules.end() &&
+        old_rule->second.rule.value == cookie_setting.second) {
+      continue;
     }
-  }
 
-  // find any removed rules
-  for (const auto& old_rule : old_rules) {
-    auto match = std::find_if(
-        brave_cookie_rules_[incognito].begin(),
-        brave_cookie_rules_[incognito].end(),
-        [&old_rule](const auto& new_rule) {
-          // we only care about the patterns here because we're looking
-          // for deleted rules, not changed rules
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern;
-        });
-    if (match == brave_cookie_rules_[incognito].end()) {
-      brave_cookie_updates.push_back(
-          Rule(old_rule.primary_pattern,
-               old_rule.secondary_pattern,
-               base::Value()));
+    BraveCookieRule rule(ToBraveCookieRule(cookie_setting.first.first,
+                                           cookie_setting.first.second,
+                                           cookie_setting.second),
+                         IsActive(cookie_setting.first, rules.shield_rules));
+    if (rule.active ||
+        (old_rule != rules.brave_cookie_rules.end() &&
+         old_rule->second.active)) {
+      changes->emplace_back(rule.rule.primary_pattern,
+                            rule.rule.secondary_pattern);
     }
-  }
 
-  // Notify brave cookie changes as ContentSettingsType::COOKIES
-  if (content_type == ContentSettingsType::PLUGINS) {
-    // PostTask here to avoid content settings autolock DCHECK
-    base::PostTask(
-        FROM_HERE,
-        {content::BrowserThread::UI, base::TaskPriority::USER_VISIBLE},
-        base::BindOnce(&BravePrefProvider::NotifyChanges,
-                       weak_factory_.GetWeakPtr(),
-                       std::move(brave_cookie_updates), incognito));
+    if (old_rule != rules.brave_cookie_rules.end())
+      old_rule->second = std::move(rule);
+    else
+      rules.brave_cookie_rules.emplace(cookie_setting.first, std::move(rule));
   }
 }
 
-void BravePrefProvider::NotifyChanges(const std::vector<Rule>& rules,
-                                      bool incognito) {
-  for (const auto& rule : rules) {
-    Notify(rule.primary_pattern,
-           rule.secondary_pattern,
+void BravePrefProvider::ScheduleNotifyChanges(
+    std::vector<PatternPair> changes) {
+  if (changes.empty())
+    return;
+
+  // Regular and incognito rules often change for the same patterns.
+  std::sort(changes.begin(), changes.end());
+  changes.erase(std::unique(changes.begin(), changes.end()), changes.end());
+
+  // PostTask here to avoid content settings autolock DCHECK
+  base::PostTask(
+      FROM_HERE,
+      {content::BrowserThread::UI, base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&BravePrefProvider::NotifyChanges,
+                     weak_factory_.GetWeakPtr(),
+                     std::move(changes)));
+}
+
+void BravePrefProvider::NotifyChanges(
+    const std::vector<PatternPair>& changes) {
+  for (const auto& change : changes) {
+    Notify(change.first,
+           change.second,
            ContentSettingsType::COOKIES,
            "");
   }
@@ -423,13 +587,27 @@ void BravePrefProvider::NotifyChanges(const std::vector<Rule>& rules,
 
 void BravePrefProvider::OnCookiePrefsChanged(
     const std::string& pref) {
-  OnCookieSettingsChanged(ContentSettingsType::PLUGINS);
+  std::vector<PatternPair> changes;
+  UpdateGoogleLoginRule(&changes);
+  ScheduleNotifyChanges(std::move(changes));
 }
 
 void BravePrefProvider::OnCookieSettingsChanged(
-    ContentSettingsType content_type) {
-  UpdateCookieRules(content_type, true);
-  UpdateCookieRules(content_type, false);
+    ContentSettingsType content_type,
+    const std::string& resource_identifier) {
+  std::vector<PatternPair> changes;
+  for (bool incognito : {true, false}) {
+    if (content_type == ContentSettingsType::COOKIES) {
+      // Chromium cookie settings are notified by PrefProvider itself.
+      UpdateChromiumCookieRules(incognito);
+    } else if (resource_identifier == brave_shields::kBraveShields) {
+      UpdateShieldRules(incognito, &changes);
+    } else {
+      UpdateBraveCookieRules(incognito, &changes);
+    }
+  }
+  // Notify brave cookie changes as ContentSettingsType::COOKIES
+  ScheduleNotifyChanges(std::move(changes));
 }
 
 void BravePrefProvider::OnContentSettingChanged(
@@ -441,7 +619,7 @@ void BravePrefProvider::OnContentSettingChanged(
       (content_type == ContentSettingsType::PLUGINS &&
           (resource_identifier == brave_shields::kCookies ||
            resource_identifier == brave_shields::kBraveShields))) {
-    OnCookieSettingsChanged(content_type);
+    OnCookieSettingsChanged(content_type, resource_identifier);
   }
 }
 
@@ -9,9 +9,11 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/memory/weak_ptr.h"
+#include "base/optional.h"
 #include "components/content_settings/core/browser/content_settings_observer.h"
 #include "components/content_settings/core/browser/content_settings_pref_provider.h"
 #include "components/prefs/pref_change_registrar.h"
@@ -53,13 +55,75 @@ class BravePrefProvider : public PrefProvider,
   FRIEND_TEST_ALL_PREFIXES(BravePrefProviderTest, TestShieldsSettingsMigration);
   FRIEND_TEST_ALL_PREFIXES(BravePrefProviderTest,
                            TestShieldsSettingsMigrationVersion);
+
+  using PatternPair = std::pair<ContentSettingsPattern, ContentSettingsPattern>;
+
+  // Orders rules by precedence, highest first, which is the order
+  // PrefProvider::GetRuleIterator returns them in.
+  struct PatternPairPrecedence {
+    bool operator()(const PatternPair& lhs, const PatternPair& rhs) const {
+      return lhs > rhs;
+    }
+  };
+
+  using RuleMap = std::map<PatternPair, base::Value, PatternPairPrecedence>;
+
+  class CookieRuleIterator;
+
+  // A brave cookie setting in cookie rule form (see CloneRule) and whether
+  // it currently applies, i.e. shields are not down for its site.
+  struct BraveCookieRule {
+    BraveCookieRule(Rule rule, bool active);
+    BraveCookieRule(BraveCookieRule&& other);
+    BraveCookieRule& operator=(BraveCookieRule&& other);
+    ~BraveCookieRule();
+
+    Rule rule;
+    bool active;
+  };
+
+  using BraveCookieRuleMap =
+      std::map<PatternPair, BraveCookieRule, PatternPairPrecedence>;
+
+  // The settings cookie rules are derived from, kept so that a change to
+  // one of them only re-derives the rules for the patterns that changed.
+  struct CookieRules {
+    CookieRules();
+    CookieRules(CookieRules&& other);
+    CookieRules& operator=(CookieRules&& other);
+    ~CookieRules();
+
+    std::vector<Rule> chromium_rules;
+    // Shields settings, keyed by their patterns.
+    RuleMap shield_rules;
+    // Brave cookie settings, keyed by their patterns as stored for
+    // ContentSettingsType::PLUGINS.
+    BraveCookieRuleMap brave_cookie_rules;
+  };
+
   void MigrateShieldsSettings(bool incognito);
   void MigrateShieldsSettingsV1ToV2();
   void MigrateShieldsSettingsV1ToV2ForOneType(ContentSettingsType content_type,
                                               const std::string& resource_id);
-  void UpdateCookieRules(ContentSettingsType content_type, bool incognito);
-  void OnCookieSettingsChanged(ContentSettingsType content_type);
-  void NotifyChanges(const std::vector<Rule>& rules, bool incognito);
+  static bool IsActive(const PatternPair& cookie_patterns,
+                       const RuleMap& shield_rules);
+  RuleMap GetRuleMap(ContentSettingsType content_type,
+                     const std::string& resource_identifier,
+                     bool incognito) const;
+  // Derives all cookie rules from scratch.
+  void RebuildCookieRules(bool incognito);
+  // Each of these re-reads one of the settings cookie rules are derived from
+  // and re-derives only the rules affected by the settings that changed,
+  // adding their patterns to |changes|.
+  void UpdateGoogleLoginRule(std::vector<PatternPair>* changes);
+  void UpdateChromiumCookieRules(bool incognito);
+  void UpdateShieldRules(bool incognito, std::vector<PatternPair>* changes);
+  void UpdateBraveCookieRules(bool incognito,
+                              std::vector<PatternPair>* changes);
+  void OnCookieSettingsChanged(ContentSettingsType content_type,
+                               const std::string& resource_identifier);
+  void ScheduleNotifyChanges(std::vector<PatternPair> changes);
+  void NotifyChanges(const std::vector<PatternPair>& changes);
 
   // content_settings::Observer overrides:
   void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
@@ -71,8 +135,10 @@ class BravePrefProvider : public PrefProvider,
   // PrefProvider::pref_change_registrar_ alreay has plugin type.
   PrefChangeRegistrar brave_pref_change_registrar_;
 
-  std::map<bool /* is_incognito */, std::vector<Rule>> cookie_rules_;
-  std::map<bool /* is_incognito */, std::vector<Rule>> brave_cookie_rules_;
+  // Allows accounts.google.com to use cookies in a 3p context when the
+  // kGoogleLoginControlType preference is set.
+  base::Optional<Rule> google_login_rule_;
+  std::map<bool /* is_incognito */, CookieRules> cookie_rules_;
 
   base::WeakPtrFactory<BravePrefProvider> weak_factory_;
 
@@ -3,16 +3,24 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/optional.h"
+#include "base/run_loop.h"
+#include "brave/common/network_constants.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/components/content_settings/core/browser/brave_content_settings_pref_provider.h"
 #include "chrome/test/base/testing_profile.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
 #include "components/content_settings/core/browser/content_settings_registry.h"
+#include "components/content_settings/core/browser/content_settings_rule.h"
 #include "components/content_settings/core/common/content_settings.h"
 #include "components/content_settings/core/common/content_settings_pattern.h"
 #include "components/content_settings/core/common/content_settings_utils.h"
@@ -28,6 +36,130 @@ namespace content_settings {
 namespace {
 
 using GURLSourcePair = std::pair<GURL, const char*>;
+using CookieRuleList =
+    std::vector<std::tuple<std::string, std::string, ContentSetting>>;
+
+CookieRuleList GetCookieRules(const BravePrefProvider& provider,
+                              bool incognito) {
+  CookieRuleList rules;
+  auto rule_iterator = provider.GetRuleIterator(ContentSettingsType::COOKIES,
+                                                "", incognito);
+  while (rule_iterator && rule_iterator->HasNext()) {
+    auto rule = rule_iterator->Next();
+    rules.emplace_back(rule.primary_pattern.ToString(),
+                       rule.secondary_pattern.ToString(),
+                       ValueToContentSetting(&rule.value));
+  }
+  return rules;
+}
+
+// Copy of the cookie rule derivation BravePrefProvider used before cookie
+// rules were derived incrementally, kept as a reference for the rules and
+// the order they are returned in.
+bool IsBaselineCookieRuleActive(const Rule& cookie_rule,
+                                const std::vector<Rule>& shield_rules) {
+  // don't include default rules in the iterator
+  if (cookie_rule.primary_pattern == ContentSettingsPattern::Wildcard() &&
+      (cookie_rule.secondary_pattern == ContentSettingsPattern::Wildcard() ||
+       cookie_rule.secondary_pattern ==
+          ContentSettingsPattern::FromString("https://firstParty/*"))) {
+    return false;
+  }
+
+  for (const auto& shield_rule : shield_rules) {
+    auto primary_compare =
+        shield_rule.primary_pattern.Compare(cookie_rule.primary_pattern);
+    if (primary_compare == ContentSettingsPattern::IDENTITY ||
+        primary_compare == ContentSettingsPattern::SUCCESSOR) {
+      return
+          ValueToContentSetting(&shield_rule.value) != CONTENT_SETTING_BLOCK;
+    }
+  }
+
+  return true;
+}
+
+CookieRuleList GetBaselineCookieRules(const BravePrefProvider& provider,
+                                      PrefService* prefs,
+                                      bool incognito) {
+  CookieRuleList rules;
+  auto add_rule = [&rules](const ContentSettingsPattern& primary_pattern,
+                           const ContentSettingsPattern& secondary_pattern,
+                           const base::Value& value) {
+    rules.emplace_back(primary_pattern.ToString(),
+                       secondary_pattern.ToString(),
+                       ValueToContentSetting(&value));
+  };
+
+  if (prefs->GetBoolean(kGoogleLoginControlType)) {
+    add_rule(ContentSettingsPattern::FromString(kGoogleOAuthPattern),
+             ContentSettingsPattern::Wildcard(),
+             *ContentSettingToValue(CONTENT_SETTING_ALLOW));
+  }
+
+  auto chromium_cookies_iterator = provider.PrefProvider::GetRuleIterator(
+      ContentSettingsType::COOKIES, "", incognito);
+  while (chromium_cookies_iterator && chromium_cookies_iterator->HasNext()) {
+    auto rule = chromium_cookies_iterator->Next();
+    add_rule(rule.primary_pattern, rule.secondary_pattern, rule.value);
+  }
+
+  std::vector<Rule> shield_rules;
+  auto brave_shields_iterator = provider.PrefProvider::GetRuleIterator(
+      ContentSettingsType::PLUGINS, brave_shields::kBraveShields, incognito);
+  while (brave_shields_iterator && brave_shields_iterator->HasNext())
+    shield_rules.push_back(brave_shields_iterator->Next());
+
+  // Brave cookie rules have their patterns swapped.
+  auto brave_cookies_iterator = provider.PrefProvider::GetRuleIterator(
+      ContentSettingsType::PLUGINS, brave_shields::kCookies, incognito);
+  while (brave_cookies_iterator && brave_cookies_iterator->HasNext()) {
+    auto rule = brave_cookies_iterator->Next();
+    if (IsBaselineCookieRuleActive(rule, shield_rules))
+      add_rule(rule.secondary_pattern, rule.primary_pattern, rule.value);
+  }
+
+  // Shields down rules.
+  for (const auto& shield_rule : shield_rules) {
+    if (ValueToContentSetting(&shield_rule.value) == CONTENT_SETTING_BLOCK) {
+      add_rule(ContentSettingsPattern::Wildcard(), shield_rule.primary_pattern,
+               *ContentSettingToValue(CONTENT_SETTING_ALLOW));
+    }
+  }
+
+  return rules;
+}
+
+// Records the cookie rule patterns the provider notifies observers of.
+class CookieRulesObserver : public Observer {
+ public:
+  CookieRulesObserver() = default;
+  ~CookieRulesObserver() override = default;
+
+  void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
+                               const ContentSettingsPattern& secondary_pattern,
+                               ContentSettingsType content_type,
+                               const std::string& resource_identifier)
+      override {
+    if (content_type == ContentSettingsType::COOKIES)
+      notified_.emplace_back(primary_pattern, secondary_pattern);
+  }
+
+  bool WasNotified(const ContentSettingsPattern& primary_pattern,
+                   const ContentSettingsPattern& secondary_pattern) const {
+    return std::find(notified_.begin(), notified_.end(),
+                     std::make_pair(primary_pattern, secondary_pattern)) !=
+           notified_.end();
+  }
+
+  void Reset() { notified_.clear(); }
+
+ private:
+  std::vector<std::pair<ContentSettingsPattern, ContentSettingsPattern>>
+      notified_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieRulesObserver);
+};
 
 ContentSettingsPattern SecondaryUrlToPattern(const GURL& gurl) {
   CHECK(gurl == GURL() || gurl == GURL("https://firstParty/*"));
@@ -336,4 +468,133 @@ TEST_F(BravePrefProviderTest, TestShieldsSettingsMigrationVersion) {
   provider.ShutdownOnUIThread();
 }
 
+TEST_F(BravePrefProviderTest, IncrementalCookieRulesMatchBaseline) {
+  PrefService* prefs = testing_profile()->GetPrefs();
+  CookieRulesObserver observer;
+  BravePrefProvider provider(prefs, false /* incognito */,
+                             true /* store_last_modified */);
+  provider.AddObserver(&observer);
+
+  const auto first_party =
+      ContentSettingsPattern::FromString("https://firstParty/*");
+  const auto brave = ContentSettingsPattern::FromString("[*.]brave.com");
+  const auto sub_brave =
+      ContentSettingsPattern::FromString("[*.]sub.brave.com");
+  const auto example = ContentSettingsPattern::FromString("[*.]example.com");
+  const auto google_oauth =
+      ContentSettingsPattern::FromString(kGoogleOAuthPattern);
+  const auto wildcard = ContentSettingsPattern::Wildcard();
+
+  auto set_setting = [&provider](const ContentSettingsPattern& primary,
+                                 const ContentSettingsPattern& secondary,
+                                 ContentSettingsType content_type,
+                                 const std::string& resource_identifier,
+                                 ContentSetting setting) {
+    provider.SetWebsiteSetting(primary, secondary, content_type,
+                               resource_identifier,
+                               ContentSettingToValue(setting));
+  };
+  auto set_cookies = [&](const ContentSettingsPattern& pattern,
+                         ContentSetting setting) {
+    set_setting(pattern, wildcard, ContentSettingsType::PLUGINS,
+                brave_shields::kCookies, setting);
+    set_setting(pattern, first_party, ContentSettingsType::PLUGINS,
+                brave_shields::kCookies, CONTENT_SETTING_ALLOW);
+  };
+  auto set_shields = [&](const ContentSettingsPattern& pattern,
+                         ContentSetting setting) {
+    set_setting(pattern, wildcard, ContentSettingsType::PLUGINS,
+                brave_shields::kBraveShields, setting);
+  };
+  auto check_matches_baseline = [&provider, prefs](const char* step) {
+    SCOPED_TRACE(step);
+    EXPECT_EQ(GetBaselineCookieRules(provider, prefs, false),
+              GetCookieRules(provider, false));
+    EXPECT_EQ(GetBaselineCookieRules(provider, prefs, true),
+              GetCookieRules(provider, true));
+  };
+  // Brave cookie rules are notified with their patterns swapped, see
+  // CloneRule.
+  auto expect_notified = [&observer](const ContentSettingsPattern& primary,
+                                     const ContentSettingsPattern& secondary) {
+    base::RunLoop().RunUntilIdle();
+    EXPECT_TRUE(observer.WasNotified(primary, secondary))
+        << primary.ToString() << ", " << secondary.ToString();
+  };
+
+  check_matches_baseline("initial");
+
+  set_cookies(brave, CONTENT_SETTING_BLOCK);
+  set_cookies(sub_brave, CONTENT_SETTING_ALLOW);
+  set_cookies(example, CONTENT_SETTING_BLOCK);
+  check_matches_baseline("brave cookie settings added");
+  expect_notified(wildcard, brave);
+  expect_notified(first_party, sub_brave);
+  expect_notified(wildcard, example);
+
+  observer.Reset();
+  set_shields(brave, CONTENT_SETTING_BLOCK);
+  check_matches_baseline("shields down for a parent domain");
+  // The shields down rule and the brave cookie rules it deactivates.
+  expect_notified(wildcard, brave);
+  expect_notified(first_party, brave);
+  expect_notified(first_party, sub_brave);
+  EXPECT_FALSE(observer.WasNotified(wildcard, example));
+
+  observer.Reset();
+  set_shields(sub_brave, CONTENT_SETTING_ALLOW);
+  check_matches_baseline("shields up for a subdomain");
+  expect_notified(wildcard, sub_brave);
+  expect_notified(first_party, sub_brave);
+
+  observer.Reset();
+  set_cookies(example, CONTENT_SETTING_ALLOW);
+  check_matches_baseline("brave cookie setting changed");
+  expect_notified(wildcard, example);
+  EXPECT_FALSE(observer.WasNotified(first_party, brave));
+
+  set_setting(ContentSettingsPattern::FromString("[*.]chromium.org"),
+              wildcard, ContentSettingsType::COOKIES, std::string(),
+              CONTENT_SETTING_BLOCK);
+  check_matches_baseline("chromium cookie setting added");
+
+  // The google login rule is allowed by default.
+  observer.Reset();
+  prefs->SetBoolean(kGoogleLoginControlType, false);
+  check_matches_baseline("google login disallowed");
+  for (const auto& rule : GetCookieRules(provider, false))
+    EXPECT_NE(google_oauth.ToString(), std::get<0>(rule));
+  expect_notified(google_oauth, wildcard);
+
+  observer.Reset();
+  prefs->SetBoolean(kGoogleLoginControlType, true);
+  check_matches_baseline("google login allowed");
+  ASSERT_FALSE(GetCookieRules(provider, false).empty());
+  EXPECT_EQ(std::make_tuple(google_oauth.ToString(), wildcard.ToString(),
+                            CONTENT_SETTING_ALLOW),
+            GetCookieRules(provider, false).front());
+  expect_notified(google_oauth, wildcard);
+
+  observer.Reset();
+  set_shields(brave, CONTENT_SETTING_DEFAULT);
+  check_matches_baseline("shields setting removed");
+  expect_notified(wildcard, brave);
+  expect_notified(first_party, brave);
+
+  observer.Reset();
+  set_setting(sub_brave, wildcard, ContentSettingsType::PLUGINS,
+              brave_shields::kCookies, CONTENT_SETTING_DEFAULT);
+  check_matches_baseline("brave cookie setting removed");
+  expect_notified(wildcard, sub_brave);
+
+  // A provider created from the same prefs derives the same rules.
+  BravePrefProvider new_provider(prefs, false /* incognito */,
+                                 true /* store_last_modified */);
+  EXPECT_EQ(GetCookieRules(provider, false),
+            GetCookieRules(new_provider, false));
+
+  new_provider.ShutdownOnUIThread();
+  provider.ShutdownOnUIThread();
+}
+
 }  //  namespace content_settings
@@ -214,6 +214,10 @@ declare namespace chrome.braveShields {
     addListener: (callback: (detail: BlockDetails) => void) => void
     emit: (detail: BlockDetails) => void
   }
+  const onBlockedBatch: {
+    addListener: (callback: (details: BlockDetails[]) => void) => void
+    emit: (details: BlockDetails[]) => void
+  }
 
   const allowScriptsOnce: any
   const setBraveShieldsEnabledAsync: any
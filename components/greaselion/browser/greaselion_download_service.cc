@@ -17,8 +17,6 @@
 #include "base/macros.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
-#include "base/task/post_task.h"
-#include "base/task_runner_util.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
@@ -160,12 +158,11 @@ void GreaselionDownloadService::OnDevModeLocalFileChanged(
 void GreaselionDownloadService::LoadDirectlyFromResourcePath() {
   base::FilePath dat_file_path =
       resource_dir_.AppendASCII(kGreaselionConfigFile);
-  base::PostTaskAndReplyWithResult(
-      GetTaskRunner().get(), FROM_HERE,
-      base::BindOnce(&brave_component_updater::GetDATFileAsString,
-                    dat_file_path),
-      base::BindOnce(&GreaselionDownloadService::OnDATFileDataReady,
-                    weak_factory_.GetWeakPtr()));
+  LoadData("Greaselion",
+           base::BindOnce(&brave_component_updater::GetDATFileAsString,
+                          dat_file_path),
+           base::BindOnce(&GreaselionDownloadService::OnDATFileDataReady,
+                          weak_factory_.GetWeakPtr()));
 }
 GreaselionDownloadService::~GreaselionDownloadService() {}
 
@@ -222,11 +219,6 @@ GreaselionDownloadService::rules() {
   return &rules_;
 }
 
-scoped_refptr<base::SequencedTaskRunner>
-GreaselionDownloadService::GetTaskRunner() {
-  return local_data_files_service()->GetTaskRunner();
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 
 // The factory
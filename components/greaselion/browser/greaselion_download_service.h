@@ -85,7 +85,6 @@ class GreaselionDownloadService : public LocalDataFilesObserver {
   ~GreaselionDownloadService() override;
 
   std::vector<std::unique_ptr<GreaselionRule>>* rules();
-  scoped_refptr<base::SequencedTaskRunner> GetTaskRunner();
 
   // implementation of LocalDataFilesObserver
   void OnComponentReady(const std::string& component_id,
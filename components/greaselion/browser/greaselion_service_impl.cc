@@ -16,16 +16,19 @@
 #include "base/bind_helpers.h"
 #include "base/command_line.h"
 #include "base/feature_list.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/json/json_file_value_serializer.h"
 #include "base/one_shot_event.h"
 #include "base/sequenced_task_runner.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/post_task.h"
 #include "base/task_runner_util.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "brave/common/brave_features.h"
 #include "brave/common/brave_switches.h"
@@ -33,6 +36,7 @@
 #include "brave/components/greaselion/browser/greaselion_download_service.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "chrome/common/chrome_paths.h"
+#include "crypto/secure_hash.h"
 #include "crypto/sha2.h"
 #include "extensions/browser/extension_registry.h"
 #include "extensions/browser/extension_system.h"
@@ -47,44 +51,30 @@ using extensions::Manifest;
 
 namespace {
 
-// Wraps a Greaselion rule in a component. The component is stored as an
-// unpacked extension in the system temp dir. Returns a valid extension that the
-// caller should take ownership of, or nullptr.
-//
-// NOTE: This function does file IO and should not be called on the UI thread.
-// NOTE: The caller takes ownership of the directory at extension->path() on the
-// returned object.
-scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
-    greaselion::GreaselionRule* rule,
-    const base::FilePath& extensions_dir) {
-  base::FilePath install_temp_dir =
-      extensions::file_util::GetInstallTempDir(extensions_dir);
-  if (install_temp_dir.empty()) {
-    LOG(ERROR) << "Could not get path to profile temp directory";
-    return nullptr;
-  }
+// Converted rules are cached in this directory next to the profile's
+// extensions directory, one subdirectory per rule content hash.
+const base::FilePath::CharType kGreaselionCacheDirName[] =
+    FILE_PATH_LITERAL("Greaselion");
 
-  base::ScopedTempDir temp_dir;
-  if (!temp_dir.CreateUniqueTempDirUnderPath(install_temp_dir)) {
-    LOG(ERROR) << "Could not create Greaselion temp directory";
-    return nullptr;
-  }
+// Bump this whenever the way rules are converted to extensions changes so
+// that previously cached extensions are not reused.
+const char kGreaselionCacheFormatVersion[] = "1";
 
-  // Create the manifest
-  std::unique_ptr<base::DictionaryValue> root(new base::DictionaryValue);
+// Cached extensions that haven't been used for this long are deleted.
+constexpr base::TimeDelta kGreaselionCacheEntryMaxAge =
+    base::TimeDelta::FromDays(30);
 
-  // manifest version is always 2
-  // see kModernManifestVersion in src/extensions/common/extension.cc
-  root->SetIntPath(extensions::manifest_keys::kManifestVersion, 2);
+base::FilePath GetGreaselionCacheDir(const base::FilePath& extensions_dir) {
+  return extensions_dir.DirName().Append(kGreaselionCacheDirName);
+}
 
-  // Create the public key.
-  // Greaselion scripts are not signed, but the public key for an extension
-  // doubles as its unique identity, and we need one of those, so we add the
-  // rule name to a known Brave domain and hash the result to create a
-  // public key.
+// Greaselion scripts are not signed, but the public key for an extension
+// doubles as its unique identity, and we need one of those, so we add the
+// rule name to a known Brave domain and hash the result to create a
+// public key.
+std::string GetGreaselionRulePublicKey(const std::string& script_name) {
   char raw[crypto::kSHA256Length] = {0};
   std::string key;
-  std::string script_name = rule->name();
   const base::CommandLine& command_line =
       *base::CommandLine::ForCurrentProcess();
   if (!command_line.HasSwitch(switches::kUseGoUpdateDev) &&
@@ -98,11 +88,64 @@ scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
                              crypto::kSHA256Length);
   }
   base::Base64Encode(base::StringPiece(raw, crypto::kSHA256Length), &key);
+  return key;
+}
 
+// Hashes everything that ends up in the extension converted from |rule|,
+// including the contents of its scripts. Returns an empty string if a script
+// can't be read.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+std::string GetGreaselionRuleContentHash(greaselion::GreaselionRule* rule) {
+  std::unique_ptr<crypto::SecureHash> hash =
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256);
+  auto update = [&hash](const std::string& input) {
+    // Length prefixes keep adjacent fields from running into each other.
+    const std::string length = base::NumberToString(input.size()) + ":";
+    hash->Update(length.data(), length.size());
+    hash->Update(input.data(), input.size());
+  };
+
+  update(kGreaselionCacheFormatVersion);
+  update(rule->name());
+  update(GetGreaselionRulePublicKey(rule->name()));
+  update(rule->run_at());
+  for (const auto& url_pattern : rule->url_patterns())
+    update(url_pattern);
+  for (const auto& script : rule->scripts()) {
+    std::string contents;
+    if (!base::ReadFileToString(script, &contents))
+      return std::string();
+    update(script.BaseName().AsUTF8Unsafe());
+    update(contents);
+  }
+
+  uint8_t raw[crypto::kSHA256Length] = {0};
+  hash->Finish(raw, sizeof(raw));
+  // Half of the digest is plenty to tell rule versions apart and keeps paths
+  // short.
+  return base::ToLowerASCII(base::HexEncode(raw, sizeof(raw) / 2));
+}
+
+// Wraps a Greaselion rule in a component. The component is stored as an
+// unpacked extension in |extension_dir|. Returns false on failure.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+bool WriteGreaselionRuleAsExtension(greaselion::GreaselionRule* rule,
+                                    const base::FilePath& extension_dir) {
+  // Create the manifest
+  std::unique_ptr<base::DictionaryValue> root(new base::DictionaryValue);
+
+  // manifest version is always 2
+  // see kModernManifestVersion in src/extensions/common/extension.cc
+  root->SetIntPath(extensions::manifest_keys::kManifestVersion, 2);
+
+  std::string script_name = rule->name();
   root->SetStringPath(extensions::manifest_keys::kName, script_name);
   root->SetStringPath(extensions::manifest_keys::kVersion, "1.0");
   root->SetStringPath(extensions::manifest_keys::kDescription, "");
-  root->SetStringPath(extensions::manifest_keys::kPublicKey, key);
+  root->SetStringPath(extensions::manifest_keys::kPublicKey,
+                      GetGreaselionRulePublicKey(script_name));
 
   auto js_files = std::make_unique<base::ListValue>();
   for (auto script : rule->scripts())
@@ -128,7 +171,7 @@ scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
             std::move(content_scripts));
 
   base::FilePath manifest_path =
-      temp_dir.GetPath().Append(extensions::kManifestFilename);
+      extension_dir.Append(extensions::kManifestFilename);
   JSONFileValueSerializer serializer(manifest_path);
   // If you read the header file for this function, it says not to use it
   // outside unit tests because it writes to disk (which blocks the thread). I
@@ -137,30 +180,110 @@ scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
   // files to disk.
   if (!serializer.Serialize(*root)) {
     LOG(ERROR) << "Could not write Greaselion manifest";
-    return nullptr;
+    return false;
   }
 
   // Copy the script files to our extension directory.
   for (auto script : rule->scripts()) {
-    if (!base::CopyFile(script, temp_dir.GetPath().Append(script.BaseName()))) {
+    if (!base::CopyFile(script, extension_dir.Append(script.BaseName()))) {
       LOG(ERROR) << "Could not copy Greaselion script at path: "
           << script.LossyDisplayName();
-      return nullptr;
+      return false;
     }
   }
 
+  return true;
+}
+
+scoped_refptr<Extension> LoadGreaselionExtension(
+    const base::FilePath& extension_dir) {
   std::string error;
   scoped_refptr<Extension> extension = extensions::file_util::LoadExtension(
-      temp_dir.GetPath(), Manifest::COMPONENT, Extension::NO_FLAGS, &error);
+      extension_dir, Manifest::COMPONENT, Extension::NO_FLAGS, &error);
   if (!extension.get()) {
     LOG(ERROR) << "Could not load Greaselion extension";
     LOG(ERROR) << error;
     return nullptr;
   }
-
-  temp_dir.Take();  // The caller takes ownership of the directory.
   return extension;
 }
+
+// Returns the extension for a Greaselion rule. Rules are converted to
+// unpacked extensions only once per content hash; later calls, including
+// those after a restart, load the extension from the cache directory.
+// |converted| is set to true if a conversion was done. Returns a valid
+// extension that the caller should take ownership of, or nullptr.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+scoped_refptr<Extension> GetGreaselionRuleExtensionOnTaskRunner(
+    greaselion::GreaselionRule* rule,
+    const base::FilePath& extensions_dir,
+    bool* converted) {
+  const std::string content_hash = GetGreaselionRuleContentHash(rule);
+  if (content_hash.empty()) {
+    LOG(ERROR) << "Could not read Greaselion scripts";
+    return nullptr;
+  }
+
+  const base::FilePath cache_dir = GetGreaselionCacheDir(extensions_dir);
+  const base::FilePath extension_dir = cache_dir.AppendASCII(content_hash);
+  if (base::PathExists(extension_dir)) {
+    if (base::PathExists(extension_dir.Append(extensions::kManifestFilename))) {
+      // Keep the entry from being pruned as long as it's in use.
+      const base::Time now = base::Time::Now();
+      base::TouchFile(extension_dir, now, now);
+      if (scoped_refptr<Extension> extension =
+              LoadGreaselionExtension(extension_dir))
+        return extension;
+    }
+    // The cached copy is broken or incomplete, e.g. it lost its manifest, so
+    // make room for converting the rule again.
+    if (!base::DeleteFileRecursively(extension_dir)) {
+      LOG(ERROR) << "Could not delete broken Greaselion cache entry";
+      return nullptr;
+    }
+  }
+
+  if (!base::CreateDirectory(cache_dir)) {
+    LOG(ERROR) << "Could not create Greaselion cache directory";
+    return nullptr;
+  }
+
+  // Write the extension to a temp dir first so that a partially written
+  // extension is never picked up from the cache.
+  base::ScopedTempDir temp_dir;
+  if (!temp_dir.CreateUniqueTempDirUnderPath(cache_dir)) {
+    LOG(ERROR) << "Could not create Greaselion temp directory";
+    return nullptr;
+  }
+
+  *converted = true;
+  if (!WriteGreaselionRuleAsExtension(rule, temp_dir.GetPath()))
+    return nullptr;
+
+  if (!base::Move(temp_dir.GetPath(), extension_dir)) {
+    LOG(ERROR) << "Could not move Greaselion extension to the cache";
+    return nullptr;
+  }
+  temp_dir.Take();  // Now owned by the cache.
+
+  return LoadGreaselionExtension(extension_dir);
+}
+
+// Deletes cached extensions that haven't been used for a while, e.g. because
+// the rule they were converted from was changed by a component update.
+void PruneGreaselionCacheOnTaskRunner(const base::FilePath& extensions_dir) {
+  const base::Time expiration_time =
+      base::Time::Now() - kGreaselionCacheEntryMaxAge;
+  base::FileEnumerator enumerator(GetGreaselionCacheDir(extensions_dir), false,
+                                  base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (enumerator.GetInfo().GetLastModifiedTime() < expiration_time)
+      base::DeleteFileRecursively(path);
+  }
+}
+
 }  // namespace
 
 namespace greaselion {
@@ -184,6 +307,9 @@ GreaselionServiceImpl::GreaselionServiceImpl(
   extension_registry_->AddObserver(this);
   for (int i = FIRST_FEATURE; i != LAST_FEATURE; i++)
     state_[static_cast<GreaselionFeature>(i)] = false;
+  task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&PruneGreaselionCacheOnTaskRunner, install_directory_));
 }
 
 GreaselionServiceImpl::~GreaselionServiceImpl() {
@@ -233,20 +359,26 @@ void GreaselionServiceImpl::CreateAndInstallExtensions() {
   }
   for (const std::unique_ptr<GreaselionRule>& rule : *rules) {
     if (rule->Matches(state_) && rule->has_unknown_preconditions() == false) {
-      // Convert script file to component extension. This must run on extension
-      // file task runner, which was passed in in the constructor.
+      // Convert script file to component extension, or reuse the one
+      // converted earlier for the same rule contents. This must run on
+      // extension file task runner, which was passed in in the constructor.
+      auto converted = std::make_unique<bool>(false);
+      bool* converted_ptr = converted.get();
       base::PostTaskAndReplyWithResult(
           task_runner_.get(), FROM_HERE,
-          base::BindOnce(&ConvertGreaselionRuleToExtensionOnTaskRunner,
-                         rule.get(), install_directory_),
+          base::BindOnce(&GetGreaselionRuleExtensionOnTaskRunner,
+                         rule.get(), install_directory_, converted_ptr),
           base::BindOnce(&GreaselionServiceImpl::PostConvert,
-                         weak_factory_.GetWeakPtr()));
+                         weak_factory_.GetWeakPtr(), std::move(converted)));
     }
   }
 }
 
 void GreaselionServiceImpl::PostConvert(
+    std::unique_ptr<bool> converted,
     scoped_refptr<extensions::Extension> extension) {
+  if (*converted)
+    converted_rules_count_ += 1;
   if (!extension.get()) {
     all_rules_installed_successfully_ = false;
     pending_installs_ -= 1;
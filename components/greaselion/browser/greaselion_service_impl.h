@@ -7,6 +7,7 @@
 #define BRAVE_COMPONENTS_GREASELION_BROWSER_GREASELION_SERVICE_IMPL_H_
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -56,9 +57,16 @@ class GreaselionServiceImpl : public GreaselionService {
                            const extensions::Extension* extension,
                            extensions::UnloadedExtensionReason reason) override;
 
+  // Number of rules that had to be converted to extensions because no
+  // converted copy of the same rule contents was cached.
+  int converted_rules_count_for_testing() const {
+    return converted_rules_count_;
+  }
+
  private:
   void CreateAndInstallExtensions();
-  void PostConvert(scoped_refptr<extensions::Extension> extension);
+  void PostConvert(std::unique_ptr<bool> converted,
+                   scoped_refptr<extensions::Extension> extension);
   void Install(scoped_refptr<extensions::Extension> extension);
   void MaybeNotifyObservers();
 
@@ -71,6 +79,7 @@ class GreaselionServiceImpl : public GreaselionService {
   bool all_rules_installed_successfully_;
   bool update_in_progress_;
   int pending_installs_;
+  int converted_rules_count_ = 0;
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
   base::ObserverList<Observer> observers_;
   std::vector<extensions::ExtensionId> greaselion_extensions_;
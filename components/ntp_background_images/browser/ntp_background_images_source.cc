@@ -23,6 +23,10 @@ namespace ntp_background_images {
 
 namespace {
 
+// Upper bound of memory used for caching campaign images. A campaign usually
+// has a handful of wallpapers of a few hundred KB each.
+constexpr size_t kMaxImageCacheSize = 10 * 1024 * 1024;
+
 base::Optional<std::string> ReadFileToString(const base::FilePath& path) {
   std::string contents;
   if (!base::ReadFileToString(path, &contents))
@@ -30,6 +34,10 @@ base::Optional<std::string> ReadFileToString(const base::FilePath& path) {
   return contents;
 }
 
+scoped_refptr<base::RefCountedMemory> MakeImageBytes(std::string* input) {
+  return base::RefCountedString::TakeString(input);
+}
+
 bool IsSuperReferralPath(const std::string& path) {
   return path.rfind(kSuperReferralPath, 0) == 0;
 }
@@ -39,10 +47,16 @@ bool IsSuperReferralPath(const std::string& path) {
 NTPBackgroundImagesSource::NTPBackgroundImagesSource(
     NTPBackgroundImagesService* service)
     : service_(service),
+      memory_pressure_listener_(
+          base::BindRepeating(&NTPBackgroundImagesSource::OnMemoryPressure,
+                              base::Unretained(this))),
       weak_factory_(this) {
+  service_->AddObserver(this);
 }
 
-NTPBackgroundImagesSource::~NTPBackgroundImagesSource() = default;
+NTPBackgroundImagesSource::~NTPBackgroundImagesSource() {
+  service_->RemoveObserver(this);
+}
 
 std::string NTPBackgroundImagesSource::GetSource() {
   return kBrandedWallpaperHost;
@@ -63,7 +77,7 @@ void NTPBackgroundImagesSource::StartDataRequest(
 
   // Favicon data is fetched from cached folder not from component data.
   if (IsTopSiteFaviconPath(path)) {
-    GetImageFile(GetTopSiteFaviconFilePath(path), std::move(callback));
+    GetImageFile(GetTopSiteFaviconFilePath(path), false, std::move(callback));
     return;
   }
 
@@ -85,32 +99,82 @@ void NTPBackgroundImagesSource::StartDataRequest(
         images_data->backgrounds[GetWallpaperIndexFromPath(path)].image_file;
   }
 
-  GetImageFile(image_file_path, std::move(callback));
+  GetImageFile(image_file_path, true, std::move(callback));
 }
 
 void NTPBackgroundImagesSource::GetImageFile(
     const base::FilePath& image_file_path,
+    bool cache_image,
     GotDataCallback callback) {
+  if (cache_image) {
+    auto it = image_cache_.find(image_file_path);
+    if (it != image_cache_.end()) {
+      std::move(callback).Run(it->second);
+      return;
+    }
+  }
+
   base::PostTaskAndReplyWithResult(
       FROM_HERE, {base::ThreadPool(), base::MayBlock()},
       base::BindOnce(&ReadFileToString, image_file_path),
       base::BindOnce(&NTPBackgroundImagesSource::OnGotImageFile,
                      weak_factory_.GetWeakPtr(),
+                     image_file_path,
+                     cache_image ? base::make_optional(image_cache_generation_)
+                                 : base::nullopt,
                      std::move(callback)));
 }
 
 void NTPBackgroundImagesSource::OnGotImageFile(
+    const base::FilePath& image_file_path,
+    base::Optional<int> image_cache_generation,
     GotDataCallback callback,
     base::Optional<std::string> input) {
   if (!input)
     return;
 
-  scoped_refptr<base::RefCountedMemory> bytes;
-  bytes = new base::RefCountedBytes(
-       reinterpret_cast<const unsigned char*>(input->c_str()), input->length());
+  scoped_refptr<base::RefCountedMemory> bytes = MakeImageBytes(&input.value());
+  // Don't cache files read before the cache was last cleared, they may belong
+  // to a previous component version.
+  if (image_cache_generation == image_cache_generation_)
+    AddToImageCache(image_file_path, bytes);
   std::move(callback).Run(std::move(bytes));
 }
 
+void NTPBackgroundImagesSource::OnUpdated(NTPBackgroundImagesData* data) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // Component update installs images into a new directory, so cached files of
+  // the previous version are not served anymore.
+  ClearImageCache();
+}
+
+void NTPBackgroundImagesSource::AddToImageCache(
+    const base::FilePath& image_file_path,
+    scoped_refptr<base::RefCountedMemory> bytes) {
+  if (image_cache_.count(image_file_path) ||
+      image_cache_size_ + bytes->size() > kMaxImageCacheSize)
+    return;
+
+  image_cache_size_ += bytes->size();
+  image_cache_[image_file_path] = std::move(bytes);
+}
+
+void NTPBackgroundImagesSource::ClearImageCache() {
+  ++image_cache_generation_;
+  image_cache_.clear();
+  image_cache_size_ = 0;
+}
+
+void NTPBackgroundImagesSource::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  if (memory_pressure_level ==
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return;
+
+  // Images are read from disk again on demand.
+  ClearImageCache();
+}
+
 std::string NTPBackgroundImagesSource::GetMimeType(const std::string& path) {
   if (IsLogoPath(path) || IsTopSiteFaviconPath(path))
     return "image/png";
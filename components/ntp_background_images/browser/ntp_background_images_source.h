@@ -8,21 +8,29 @@
 
 #include <string>
 
+#include "base/containers/flat_map.h"
+#include "base/files/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
 #include "base/optional.h"
+#include "brave/components/ntp_background_images/browser/ntp_background_images_service.h"
 #include "content/public/browser/url_data_source.h"
 
-namespace base {
-class FilePath;
-}  // namespace base
-
 namespace ntp_background_images {
 
-class NTPBackgroundImagesService;
+struct NTPBackgroundImagesData;
 
 // This serves background image data.
-class NTPBackgroundImagesSource : public content::URLDataSource {
+// Wallpapers and logos of the current sponsored images and super referral
+// campaigns are kept in memory once requested, so that opening a new tab
+// doesn't hit the disk each time.
+class NTPBackgroundImagesSource : public content::URLDataSource,
+                                  public NTPBackgroundImagesService::Observer {
  public:
+  using ImageCache =
+      base::flat_map<base::FilePath, scoped_refptr<base::RefCountedMemory>>;
+
   explicit NTPBackgroundImagesSource(NTPBackgroundImagesService* service);
 
   ~NTPBackgroundImagesSource() override;
@@ -35,6 +43,10 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest, BasicTest);
   FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest,
                            BasicSuperReferralDataTest);
+  FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest,
+                           RepeatedRequestsAreServedFromMemory);
+  FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest,
+                           MemoryPressureClearsImageCache);
 
   // content::URLDataSource overrides:
   std::string GetSource() override;
@@ -44,10 +56,22 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   std::string GetMimeType(const std::string& path) override;
   bool AllowCaching() override;
 
+  // NTPBackgroundImagesService::Observer overrides:
+  void OnUpdated(NTPBackgroundImagesData* data) override;
+
   void GetImageFile(const base::FilePath& image_file_path,
+                    bool cache_image,
                     GotDataCallback callback);
-  void OnGotImageFile(GotDataCallback callback,
+  // |image_cache_generation| is null for images that aren't cached.
+  void OnGotImageFile(const base::FilePath& image_file_path,
+                      base::Optional<int> image_cache_generation,
+                      GotDataCallback callback,
                       base::Optional<std::string> input);
+  void AddToImageCache(const base::FilePath& image_file_path,
+                       scoped_refptr<base::RefCountedMemory> bytes);
+  void ClearImageCache();
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
   bool IsValidPath(const std::string& path) const;
   bool IsLogoPath(const std::string& path) const;
   bool IsWallpaperPath(const std::string& path) const;
@@ -56,6 +80,12 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   base::FilePath GetTopSiteFaviconFilePath(const std::string& path) const;
 
   NTPBackgroundImagesService* service_;  // not owned
+  ImageCache image_cache_;
+  size_t image_cache_size_ = 0;
+  // Bumped whenever the cache is dropped so that a stale read doesn't
+  // repopulate it.
+  int image_cache_generation_ = 0;
+  base::MemoryPressureListener memory_pressure_listener_;
   base::WeakPtrFactory<NTPBackgroundImagesSource> weak_factory_;
 };
 
@@ -6,18 +6,34 @@
 #include <memory>
 #include <string>
 
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/test/task_environment.h"
 #include "brave/components/brave_referrals/browser/brave_referrals_service.h"
 #include "brave/components/brave_referrals/buildflags/buildflags.h"
 #include "brave/components/ntp_background_images/browser/ntp_background_images_data.h"
 #include "brave/components/ntp_background_images/browser/ntp_background_images_service.h"
 #include "brave/components/ntp_background_images/browser/ntp_background_images_source.h"
+#include "brave/components/ntp_background_images/browser/url_constants.h"
 #include "brave/components/ntp_background_images/common/pref_names.h"
 #include "components/prefs/testing_pref_service.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
 
 namespace ntp_background_images {
 
+namespace {
+
+bool WriteImageFile(const base::FilePath& path, const std::string& contents) {
+  return base::WriteFile(path, contents.data(), contents.size()) ==
+         static_cast<int>(contents.size());
+}
+
+}  // namespace
+
 class NTPBackgroundImagesSourceTest : public testing::Test {
  public:
   NTPBackgroundImagesSourceTest() {}
@@ -33,7 +49,23 @@ class NTPBackgroundImagesSourceTest : public testing::Test {
                     base::Value(base::Value::Type::DICTIONARY));
   }
 
-  base::test::SingleThreadTaskEnvironment task_environment;
+  std::string RequestImage(const std::string& path) {
+    std::string data;
+    source_->StartDataRequest(
+        GURL(std::string("chrome://") + kBrandedWallpaperHost + "/" + path),
+        content::WebContents::Getter(),
+        base::BindOnce(
+            [](std::string* data,
+               scoped_refptr<base::RefCountedMemory> bytes) {
+              if (bytes)
+                data->assign(bytes->front_as<char>(), bytes->size());
+            },
+            &data));
+    task_environment.RunUntilIdle();
+    return data;
+  }
+
+  base::test::TaskEnvironment task_environment;
   TestingPrefServiceSimple local_pref_;
   std::unique_ptr<NTPBackgroundImagesService> service_;
   std::unique_ptr<NTPBackgroundImagesSource> source_;
@@ -79,6 +111,87 @@ TEST_F(NTPBackgroundImagesSourceTest, BasicTest) {
       source_->GetWallpaperIndexFromPath("sponsored-images/wallpaper-3.jpg"));
 }
 
+TEST_F(NTPBackgroundImagesSourceTest, RepeatedRequestsAreServedFromMemory) {
+  base::ScopedTempDir installed_dir;
+  ASSERT_TRUE(installed_dir.CreateUniqueTempDir());
+  const base::FilePath wallpaper_path =
+      installed_dir.GetPath().AppendASCII("background-1.jpg");
+  const base::FilePath logo_path =
+      installed_dir.GetPath().AppendASCII("logo.png");
+  ASSERT_TRUE(WriteImageFile(wallpaper_path, "wallpaper"));
+  ASSERT_TRUE(WriteImageFile(logo_path, "logo"));
+
+  const std::string test_json_string = R"(
+      {
+        "schemaVersion": 1,
+        "logo": {
+          "imageUrl": "logo.png",
+          "alt": "Technikke: For music lovers",
+          "companyName": "Technikke",
+          "destinationUrl": "https://www.brave.com/"
+        },
+        "wallpapers": [
+          {
+            "imageUrl": "background-1.jpg"
+          }
+        ]
+      })";
+  service_->si_installed_dir_ = installed_dir.GetPath();
+  service_->OnGetComponentJsonData(false, test_json_string);
+  task_environment.RunUntilIdle();
+  // Nothing is read until a new tab asks for the images.
+  EXPECT_TRUE(source_->image_cache_.empty());
+
+  EXPECT_EQ("wallpaper", RequestImage("sponsored-images/wallpaper-0.jpg"));
+  EXPECT_EQ("logo", RequestImage("sponsored-images/logo.png"));
+  EXPECT_EQ(2UL, source_->image_cache_.size());
+
+  // Images stay available without touching the disk again.
+  ASSERT_TRUE(base::DeleteFile(wallpaper_path, false));
+  ASSERT_TRUE(base::DeleteFile(logo_path, false));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ("wallpaper",
+              RequestImage("sponsored-images/wallpaper-0.jpg"));
+    EXPECT_EQ("logo",
+              RequestImage("sponsored-images/logo.png"));
+  }
+
+  // Component update drops images of the previous version.
+  service_->si_installed_dir_ = base::FilePath();
+  service_->OnGetComponentJsonData(false, test_json_string);
+  task_environment.RunUntilIdle();
+  EXPECT_TRUE(source_->image_cache_.empty());
+}
+
+TEST_F(NTPBackgroundImagesSourceTest, MemoryPressureClearsImageCache) {
+  base::ScopedTempDir installed_dir;
+  ASSERT_TRUE(installed_dir.CreateUniqueTempDir());
+  const base::FilePath wallpaper_path =
+      installed_dir.GetPath().AppendASCII("background-1.jpg");
+  ASSERT_TRUE(WriteImageFile(wallpaper_path, "wallpaper"));
+
+  service_->si_installed_dir_ = installed_dir.GetPath();
+  service_->OnGetComponentJsonData(false, R"(
+      {
+        "schemaVersion": 1,
+        "wallpapers": [ { "imageUrl": "background-1.jpg" } ]
+      })");
+  EXPECT_EQ("wallpaper",
+            RequestImage("sponsored-images/wallpaper-0.jpg"));
+  EXPECT_EQ(1UL, source_->image_cache_.size());
+
+  base::MemoryPressureListener::SimulatePressureNotification(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  task_environment.RunUntilIdle();
+  EXPECT_TRUE(source_->image_cache_.empty());
+  EXPECT_EQ(0UL, source_->image_cache_size_);
+
+  // Evicted images are read from disk and cached again on demand.
+  EXPECT_EQ("wallpaper",
+            RequestImage("sponsored-images/wallpaper-0.jpg"));
+  EXPECT_EQ(1UL, source_->image_cache_.size());
+}
+
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
 
 #if !defined(OS_LINUX)
@@ -6,6 +6,7 @@
 #include "brave/components/p3a/brave_p3a_log_store.h"
 
 #include "base/metrics/histogram_macros.h"
+#include "base/optional.h"
 #include "base/rand_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "components/prefs/pref_registry_simple.h"
@@ -47,20 +48,30 @@ void BraveP3ALogStore::RegisterPrefs(PrefRegistrySimple* registry) {
   registry->RegisterDictionaryPref(kPrefName);
 }
 
-void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
-                                   uint64_t value) {
-  LogEntry& entry = log_[histogram_name];
-  entry.value = value;
-  if (!entry.sent) {
-    DCHECK(entry.sent_timestamp.is_null());
-    unsent_entries_.insert(histogram_name);
-  }
+void BraveP3ALogStore::UpdateValues(
+    const base::flat_map<std::string, uint64_t>& values) {
+  // Only created once something actually changes.
+  base::Optional<DictionaryPrefUpdate> update;
+  for (const auto& pair : values) {
+    const std::string& histogram_name = pair.first;
+    auto iter = log_.find(histogram_name);
+    if (iter != log_.end() && iter->second.value == pair.second)
+      continue;
 
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({histogram_name, kLogValueKey},
-                  base::Value(base::NumberToString(value)));
-  update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+    LogEntry& entry = log_[histogram_name];
+    entry.value = pair.second;
+    if (!entry.sent) {
+      DCHECK(entry.sent_timestamp.is_null());
+      unsent_entries_.insert(histogram_name);
+    }
+
+    // Update the persistent value.
+    if (!update)
+      update.emplace(local_state_, kPrefName);
+    (*update)->SetPath({histogram_name, kLogValueKey},
+                       base::Value(base::NumberToString(entry.value)));
+    (*update)->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+  }
 }
 
 void BraveP3ALogStore::ResetUploadStamps() {
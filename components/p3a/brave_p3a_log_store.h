@@ -43,7 +43,9 @@ class BraveP3ALogStore : public metrics::LogStore {
 
   static void RegisterPrefs(PrefRegistrySimple* registry);
 
-  void UpdateValue(const std::string& histogram_name, uint64_t value);
+  // Updates several values with a single write to the persisted logs.
+  // Entries whose value did not change are not rewritten.
+  void UpdateValues(const base::flat_map<std::string, uint64_t>& values);
   // Marks all saved values as unsent.
   void ResetUploadStamps();
 
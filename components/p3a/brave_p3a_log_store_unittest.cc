@@ -0,0 +1,75 @@
+/* Copyright 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_log_store.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/testing_pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave {
+
+namespace {
+
+constexpr char kLogsPref[] = "p3a.logs";
+
+class TestDelegate : public BraveP3ALogStore::Delegate {
+ public:
+  std::string Serialize(base::StringPiece histogram_name,
+                        uint64_t value) const override {
+    return histogram_name.as_string() + ":" + base::NumberToString(value);
+  }
+  bool IsActualMetric(base::StringPiece histogram_name) const override {
+    return true;
+  }
+};
+
+}  // namespace
+
+class BraveP3ALogStoreTest : public testing::Test {
+ public:
+  BraveP3ALogStoreTest() : log_store_(&delegate_, &local_state_) {
+    BraveP3ALogStore::RegisterPrefs(local_state_.registry());
+    registrar_.Init(&local_state_);
+    registrar_.Add(kLogsPref,
+                   base::BindRepeating(&BraveP3ALogStoreTest::OnLogsChanged,
+                                       base::Unretained(this)));
+  }
+
+ protected:
+  void OnLogsChanged() { ++pref_writes_; }
+
+  TestingPrefServiceSimple local_state_;
+  TestDelegate delegate_;
+  BraveP3ALogStore log_store_;
+  PrefChangeRegistrar registrar_;
+  int pref_writes_ = 0;
+};
+
+TEST_F(BraveP3ALogStoreTest, BatchIsPersistedWithSingleWrite) {
+  log_store_.UpdateValues({{"Brave.A", 1}, {"Brave.B", 2}, {"Brave.C", 3}});
+  EXPECT_EQ(1, pref_writes_);
+  EXPECT_TRUE(log_store_.has_unsent_logs());
+
+  // Nothing changed, nothing to write.
+  log_store_.UpdateValues({{"Brave.A", 1}, {"Brave.B", 2}});
+  EXPECT_EQ(1, pref_writes_);
+
+  log_store_.UpdateValues({{"Brave.A", 1}, {"Brave.B", 5}});
+  EXPECT_EQ(2, pref_writes_);
+
+  const base::Value* log = local_state_.GetDictionary(kLogsPref)->FindKey(
+      "Brave.B");
+  ASSERT_TRUE(log);
+  const std::string* value = log->FindStringKey("value");
+  ASSERT_TRUE(value);
+  EXPECT_EQ("5", *value);
+}
+
+}  // namespace brave
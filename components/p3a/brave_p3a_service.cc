@@ -7,6 +7,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/i18n/timezone.h"
@@ -31,6 +33,7 @@
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
 #include "third_party/metrics_proto/reporting_info.pb.h"
 
@@ -44,6 +47,11 @@ constexpr char kDefaultUploadServerUrl[] = "https://p3a.brave.com/";
 
 constexpr uint64_t kDefaultUploadIntervalSeconds = 60;  // 1 minute.
 
+// Histograms may be recorded many times in a row, so new values are
+// collected in memory and handed to the log store in batches.
+constexpr base::TimeDelta kPendingValuesFlushDelay =
+    base::TimeDelta::FromSeconds(10);
+
 // TODO(iefremov): Provide moar histograms!
 // Whitelist for histograms that we collect. Will be replaced with something
 // updating on the fly.
@@ -149,10 +157,7 @@ void BraveP3AService::Init(
   log_store_.reset(new BraveP3ALogStore(this, local_state_));
   log_store_->LoadPersistedUnsentLogs();
   // Store values that were recorded between calling constructor and |Init()|.
-  for (const auto& entry : histogram_values_) {
-    log_store_->UpdateValue(entry.first.as_string(), entry.second);
-  }
-  histogram_values_ = {};
+  FlushPendingValues();
   // Do rotation if needed.
   const base::Time last_rotation =
       local_state_->GetTime(kLastRotationTimeStampPref);
@@ -314,20 +319,41 @@ void BraveP3AService::OnHistogramChanged(base::StringPiece histogram_name,
     return;
   }
 
-  base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                 base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI, this,
-                                histogram_name, sample, bucket));
-}
-
-void BraveP3AService::OnHistogramChangedOnUI(base::StringPiece histogram_name,
-                                             base::HistogramBase::Sample sample,
-                                             size_t bucket) {
   VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
           << histogram_name << " Sample = " << sample << " bucket = " << bucket;
-  if (!initialized_) {
-    histogram_values_[histogram_name] = bucket;
-  } else {
-    log_store_->UpdateValue(histogram_name.as_string(), bucket);
+
+  bool schedule_flush = false;
+  {
+    base::AutoLock lock(pending_values_lock_);
+    pending_values_[histogram_name] = bucket;
+    schedule_flush = !std::exchange(flush_scheduled_, true);
+  }
+  if (schedule_flush) {
+    base::PostDelayedTask(
+        FROM_HERE, {content::BrowserThread::UI},
+        base::BindOnce(&BraveP3AService::FlushPendingValues, this),
+        kPendingValuesFlushDelay);
+  }
+}
+
+void BraveP3AService::FlushPendingValues() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  std::vector<std::pair<std::string, uint64_t>> values;
+  {
+    base::AutoLock lock(pending_values_lock_);
+    flush_scheduled_ = false;
+    // Keep collecting until |Init()| creates the log store.
+    if (!initialized_)
+      return;
+    values.reserve(pending_values_.size());
+    for (const auto& entry : pending_values_)
+      values.emplace_back(entry.first.as_string(), entry.second);
+    pending_values_.clear();
+  }
+
+  if (!values.empty()) {
+    log_store_->UpdateValues(
+        base::flat_map<std::string, uint64_t>(std::move(values)));
   }
 }
 
@@ -12,6 +12,7 @@
 #include "base/containers/flat_map.h"
 #include "base/memory/ref_counted.h"
 #include "base/metrics/histogram_base.h"
+#include "base/synchronization/lock.h"
 #include "base/timer/timer.h"
 #include "brave/components/brave_prochlo/brave_prochlo_message.h"
 #include "brave/components/p3a/brave_p3a_log_store.h"
@@ -53,6 +54,11 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
 
   bool IsActualMetric(base::StringPiece histogram_name) const override;
 
+  // Folds the values recorded since the last flush into the log store. Runs
+  // on a delay after new values are recorded, and once more on shutdown so
+  // values still waiting for it are not lost.
+  void FlushPendingValues();
+
  private:
   friend class base::RefCountedThreadSafe<BraveP3AService>;
   ~BraveP3AService() override;
@@ -64,14 +70,11 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   void StartScheduledUpload();
 
   // Invoked by callbacks registered by our service. Since these callbacks
-  // can fire on any thread, this method reposts everything to UI thread.
+  // can fire on any thread, this method only records the new bucket and
+  // schedules a delayed flush on UI thread if none is pending.
   void OnHistogramChanged(base::StringPiece histogram_name,
                           base::HistogramBase::Sample sample);
 
-  void OnHistogramChangedOnUI(base::StringPiece histogram_name,
-                              base::HistogramBase::Sample sample,
-                              size_t bucket);
-
   void OnLogUploadComplete(int response_code, int error_code, bool was_https);
 
   // Restart the uploading process (i.e. mark all values as unsent).
@@ -97,9 +100,12 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   std::unique_ptr<BraveP3AUploader> uploader_;
   std::unique_ptr<BraveP3AScheduler> upload_scheduler_;
 
-  // Used to store histogram values that are produced between constructing
-  // the service and its initialization.
-  base::flat_map<base::StringPiece, size_t> histogram_values_;
+  // Latest bucket of every histogram recorded since the last flush, including
+  // those recorded between constructing the service and its initialization.
+  // Written on any thread, so guarded by |pending_values_lock_|.
+  base::Lock pending_values_lock_;
+  base::flat_map<base::StringPiece, size_t> pending_values_;
+  bool flush_scheduled_ = false;
 
   // Once fired we restart the overall uploading process.
   base::OneShotTimer rotation_timer_;
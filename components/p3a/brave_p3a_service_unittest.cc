@@ -0,0 +1,206 @@
+/* Copyright 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_service.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/scoped_command_line.h"
+#include "base/threading/simple_thread.h"
+#include "brave/components/p3a/brave_p3a_switches.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/testing_pref_service.h"
+#include "content/public/test/browser_task_environment.h"
+#include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
+#include "services/network/test/test_url_loader_factory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave {
+
+namespace {
+
+constexpr char kLogsPref[] = "p3a.logs";
+
+// Matches the delay BraveP3AService waits for before writing new values.
+constexpr base::TimeDelta kFlushDelay = base::TimeDelta::FromSeconds(10);
+
+constexpr int kExclusiveMax = 8;
+
+// Records increasing samples of a collected histogram from its own thread.
+class RecordDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit RecordDelegate(const char* histogram_name)
+      : histogram_name_(histogram_name) {}
+
+  void Run() override {
+    for (int i = 0; i < kExclusiveMax; ++i)
+      base::UmaHistogramExactLinear(histogram_name_, i, kExclusiveMax);
+  }
+
+ private:
+  const char* histogram_name_;
+};
+
+}  // namespace
+
+class BraveP3AServiceTest : public testing::Test {
+ public:
+  BraveP3AServiceTest()
+      : task_environment_(
+            content::BrowserTaskEnvironment::TimeSource::MOCK_TIME),
+        shared_url_loader_factory_(
+            base::MakeRefCounted<network::WeakWrapperSharedURLLoaderFactory>(
+                &url_loader_factory_)) {}
+
+  void SetUp() override {
+    // Keep scheduled uploads, which don't write values, out of the way, and
+    // rotations, which do, out of the hour long tests.
+    scoped_command_line_.GetProcessCommandLine()->AppendSwitch(
+        switches::kP3ADoNotRandomizeUploadInterval);
+    scoped_command_line_.GetProcessCommandLine()->AppendSwitchASCII(
+        switches::kP3ARotationIntervalSeconds,
+        base::NumberToString(base::TimeDelta::FromDays(7).InSeconds()));
+    statistics_recorder_ =
+        base::StatisticsRecorder::CreateTemporaryForTesting();
+    BraveP3AService::RegisterPrefs(local_state_.registry(),
+                                   false /* first_run */);
+    service_ = base::MakeRefCounted<BraveP3AService>(&local_state_);
+    service_->InitCallbacks();
+    service_->Init(shared_url_loader_factory_);
+
+    // Only count the writes made after initialization.
+    registrar_.Init(&local_state_);
+    registrar_.Add(kLogsPref,
+                   base::BindRepeating(&BraveP3AServiceTest::OnLogsChanged,
+                                       base::Unretained(this)));
+  }
+
+ protected:
+  void OnLogsChanged() { ++pref_writes_; }
+
+  void Record(const char* histogram_name, int sample) {
+    base::UmaHistogramExactLinear(histogram_name, sample, kExclusiveMax);
+  }
+
+  // Returns the persisted value of |histogram_name|, or an empty string.
+  std::string GetLoggedValue(const std::string& histogram_name) {
+    const base::Value* log =
+        local_state_.GetDictionary(kLogsPref)->FindKey(histogram_name);
+    if (!log)
+      return std::string();
+    const std::string* value = log->FindStringKey("value");
+    return value ? *value : std::string();
+  }
+
+  content::BrowserTaskEnvironment task_environment_;
+  base::test::ScopedCommandLine scoped_command_line_;
+  network::TestURLLoaderFactory url_loader_factory_;
+  scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory_;
+  TestingPrefServiceSimple local_state_;
+  PrefChangeRegistrar registrar_;
+  scoped_refptr<BraveP3AService> service_;
+  // Destroyed first, which drops the service's histogram callbacks.
+  std::unique_ptr<base::StatisticsRecorder> statistics_recorder_;
+  int pref_writes_ = 0;
+};
+
+TEST_F(BraveP3AServiceTest, ValuesAreWrittenInBatches) {
+  Record("Brave.Core.TabCount", 1);
+  Record("Brave.Core.TabCount", 2);
+  Record("Brave.Core.WindowCount", 3);
+  EXPECT_EQ(0, pref_writes_);
+
+  task_environment_.FastForwardBy(kFlushDelay / 2);
+  Record("Brave.Core.TabCount", 4);
+  EXPECT_EQ(0, pref_writes_);
+  EXPECT_EQ("", GetLoggedValue("Brave.Core.TabCount"));
+
+  // The flush is scheduled by the first value of the batch.
+  task_environment_.FastForwardBy(kFlushDelay / 2);
+  EXPECT_EQ(1, pref_writes_);
+  EXPECT_EQ("4", GetLoggedValue("Brave.Core.TabCount"));
+  EXPECT_EQ("3", GetLoggedValue("Brave.Core.WindowCount"));
+
+  // Recording again schedules another flush.
+  Record("Brave.Core.TabCount", 5);
+  task_environment_.FastForwardBy(kFlushDelay);
+  EXPECT_EQ(2, pref_writes_);
+  EXPECT_EQ("5", GetLoggedValue("Brave.Core.TabCount"));
+
+  // Unchanged values aren't written again.
+  Record("Brave.Core.TabCount", 5);
+  task_environment_.FastForwardBy(kFlushDelay);
+  EXPECT_EQ(2, pref_writes_);
+}
+
+TEST_F(BraveP3AServiceTest, FlushWritesPendingValuesImmediately) {
+  Record("Brave.Core.TabCount", 2);
+  EXPECT_EQ("", GetLoggedValue("Brave.Core.TabCount"));
+
+  // What happens on shutdown, before the delayed flush had a chance to run.
+  service_->FlushPendingValues();
+  EXPECT_EQ(1, pref_writes_);
+  EXPECT_EQ("2", GetLoggedValue("Brave.Core.TabCount"));
+
+  // The delayed flush has nothing left to write.
+  task_environment_.FastForwardBy(kFlushDelay);
+  EXPECT_EQ(1, pref_writes_);
+}
+
+TEST_F(BraveP3AServiceTest, PrefWritesPerHourOfMetricTraffic) {
+  const std::vector<const char*> histogram_names = {
+      "Brave.Core.TabCount", "Brave.Core.WindowCount",
+      "Brave.Core.NumberOfExtensions", "Brave.Uptime.BrowserOpenMinutes"};
+  constexpr base::TimeDelta kTrafficInterval = base::TimeDelta::FromSeconds(1);
+  constexpr base::TimeDelta kTrafficDuration = base::TimeDelta::FromHours(1);
+
+  // Every histogram changes its value once per second for an hour, which
+  // used to be one write per value.
+  int recorded_values = 0;
+  for (int i = 0; i < kTrafficDuration / kTrafficInterval; ++i) {
+    for (const char* histogram_name : histogram_names) {
+      Record(histogram_name, i % kExclusiveMax);
+      ++recorded_values;
+    }
+    task_environment_.FastForwardBy(kTrafficInterval);
+  }
+
+  EXPECT_EQ(4 * 3600, recorded_values);
+  // A single write per flush delay, however many values came in.
+  EXPECT_EQ(kTrafficDuration / kFlushDelay, pref_writes_);
+  EXPECT_EQ("7", GetLoggedValue("Brave.Core.TabCount"));
+}
+
+TEST_F(BraveP3AServiceTest, ValuesRecordedOnOtherThreads) {
+  const std::vector<const char*> histogram_names = {
+      "Brave.Core.TabCount", "Brave.Core.WindowCount",
+      "Brave.Core.NumberOfExtensions", "Brave.Uptime.BrowserOpenMinutes"};
+
+  std::vector<std::unique_ptr<RecordDelegate>> delegates;
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  for (const char* histogram_name : histogram_names) {
+    delegates.push_back(std::make_unique<RecordDelegate>(histogram_name));
+    threads.push_back(std::make_unique<base::DelegateSimpleThread>(
+        delegates.back().get(), "P3ARecord"));
+  }
+  for (auto& thread : threads)
+    thread->Start();
+  for (auto& thread : threads)
+    thread->Join();
+
+  // All threads share a single flush, which keeps the last value of each.
+  task_environment_.FastForwardBy(kFlushDelay);
+  EXPECT_EQ(1, pref_writes_);
+  for (const char* histogram_name : histogram_names)
+    EXPECT_EQ("7", GetLoggedValue(histogram_name)) << histogram_name;
+}
+
+}  // namespace brave
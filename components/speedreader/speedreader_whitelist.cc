@@ -40,8 +40,9 @@ void SpeedreaderWhitelist::OnComponentReady(const std::string& component_id,
                                             const std::string& manifest) {
   base::PostTaskAndReplyWithResult(
       FROM_HERE, {base::ThreadPool(), base::MayBlock()},
-      base::BindOnce(&brave_component_updater::LoadDATFileData<adblock::Engine>,
-                     install_dir.Append(kDatFileName)),
+      base::BindOnce(
+          &brave_component_updater::LoadMappedDATFileData<adblock::Engine>,
+          install_dir.Append(kDatFileName)),
       base::BindOnce(&SpeedreaderWhitelist::OnGetDATFileData,
                      weak_factory_.GetWeakPtr()));
 }
@@ -56,8 +57,13 @@ bool SpeedreaderWhitelist::IsWhitelisted(const GURL& url) {
                           &saved_from_exception, &redirect);
 }
 
-void SpeedreaderWhitelist::OnGetDATFileData(GetDATFileDataResult result) {
-  engine_ = std::move(result.first);
+void SpeedreaderWhitelist::OnGetDATFileData(
+    std::unique_ptr<adblock::Engine> engine) {
+  if (!engine) {
+    LOG(ERROR) << "Could not load speedreader whitelist data";
+    return;
+  }
+  engine_ = std::move(engine);
 }
 
 }  // namespace speedreader
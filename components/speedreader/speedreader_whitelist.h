@@ -37,10 +37,7 @@ class SpeedreaderWhitelist : public brave_component_updater::BraveComponent {
                         const base::FilePath& install_dir,
                         const std::string& manifest) override;
 
-  using GetDATFileDataResult =
-      brave_component_updater::LoadDATFileDataResult<adblock::Engine>;
-
-  void OnGetDATFileData(GetDATFileDataResult result);
+  void OnGetDATFileData(std::unique_ptr<adblock::Engine> engine);
 
   std::unique_ptr<adblock::Engine> engine_;
   base::WeakPtrFactory<SpeedreaderWhitelist> weak_factory_{this};
@@ -70,6 +70,22 @@ describe('shieldsPanelActions', () => {
     })
   })
 
+  it('resourcesBlocked action', () => {
+    const details: BlockDetails[] = [{
+      blockType: 'ads',
+      tabId: 2,
+      subresource: 'https://www.brave.com/test'
+    }, {
+      blockType: 'trackers',
+      tabId: 2,
+      subresource: 'https://www.brave.com/test2'
+    }]
+    expect(actions.resourcesBlocked(details)).toEqual({
+      type: types.RESOURCES_BLOCKED,
+      details
+    })
+  })
+
   it('blockAdsTrackers action', () => {
     const setting: BlockOptions = 'allow'
     expect(actions.blockAdsTrackers(setting)).toEqual({
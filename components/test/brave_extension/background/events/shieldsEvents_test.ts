@@ -24,4 +24,21 @@ describe('shieldsEvents events', () => {
       chrome.braveShields.onBlocked.emit(blockedResource)
     })
   })
+  describe('chrome.braveShields.onBlockedBatch listener', () => {
+    let spy: jest.SpyInstance
+    beforeEach(() => {
+      spy = jest.spyOn(actions, 'resourcesBlocked')
+    })
+    afterEach(() => {
+      spy.mockRestore()
+    })
+    it('forwards the whole batch to actions.resourcesBlocked', (cb) => {
+      chrome.braveShields.onBlockedBatch.addListener((details) => {
+        expect(spy).toHaveBeenCalledTimes(1)
+        expect(spy).toBeCalledWith([blockedResource, blockedResource])
+        cb()
+      })
+      chrome.braveShields.onBlockedBatch.emit([blockedResource, blockedResource])
+    })
+  })
 })
@@ -8,7 +8,7 @@ import * as windowTypes from '../../../../brave_extension/extension/brave_extens
 import * as tabTypes from '../../../../brave_extension/extension/brave_extension/constants/tabTypes'
 import * as webNavigationTypes from '../../../../brave_extension/extension/brave_extension/constants/webNavigationTypes'
 import { State } from '../../../../brave_extension/extension/brave_extension/types/state/shieldsPannelState'
-import { ShieldDetails } from '../../../../brave_extension/extension/brave_extension/types/actions/shieldsPanelActions'
+import { BlockDetails, ShieldDetails } from '../../../../brave_extension/extension/brave_extension/types/actions/shieldsPanelActions'
 
 // APIs
 import * as shieldsAPI from '../../../../brave_extension/extension/brave_extension/background/api/shieldsAPI'
@@ -809,6 +809,68 @@ describe('braveShieldsPanelReducer', () => {
     })
   })
 
+  describe('RESOURCES_BLOCKED', () => {
+    let spy: jest.SpyInstance
+    beforeEach(() => {
+      spy = jest.spyOn(browserActionAPI, 'setBadgeText')
+    })
+    afterEach(() => {
+      spy.mockRestore()
+    })
+    it('applies the whole batch with a single badge update', () => {
+      const nextState = shieldsPanelReducer(state, {
+        type: types.RESOURCES_BLOCKED,
+        details: [{
+          blockType: 'ads',
+          tabId: 2,
+          subresource: 'https://test.brave.com'
+        }, {
+          blockType: 'ads',
+          tabId: 2,
+          subresource: 'https://test.brave.com'
+        }, {
+          blockType: 'trackers',
+          tabId: 2,
+          subresource: 'https://test2.brave.com'
+        }]
+      })
+      expect(nextState).toEqual({
+        ...state,
+        tabs: {
+          ...state.tabs,
+          2: {
+            ...state.tabs[2],
+            adsBlocked: 1,
+            adsBlockedResources: [ 'https://test.brave.com' ],
+            trackersBlocked: 1,
+            trackersBlockedResources: [ 'https://test2.brave.com' ]
+          }
+        }
+      })
+      expect(spy).toBeCalledTimes(1)
+    })
+    it('matches applying each detail on its own', () => {
+      const details: BlockDetails[] = [{
+        blockType: 'javascript',
+        tabId: 2,
+        subresource: 'https://test.brave.com/index.js'
+      }, {
+        blockType: 'fingerprinting',
+        tabId: 3,
+        subresource: 'https://test.brave.com'
+      }]
+      const expectedState = details.reduce((nextState, detail) =>
+        shieldsPanelReducer(nextState, {
+          type: types.RESOURCE_BLOCKED,
+          details: detail
+        }), state)
+      expect(shieldsPanelReducer(state, {
+        type: types.RESOURCES_BLOCKED,
+        details
+      })).toEqual(expectedState)
+    })
+  })
+
   describe('BLOCK_ADS_TRACKERS', () => {
     let reloadTabSpy: jest.SpyInstance
     let setAllowAdsSpy: jest.SpyInstance
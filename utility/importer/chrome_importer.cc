@@ -5,16 +5,22 @@
 
 #include "brave/utility/importer/chrome_importer.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "base/atomic_sequence_num.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
+#include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/system/sys_info.h"
+#include "base/threading/simple_thread.h"
 #include "base/values.h"
 #include "build/build_config.h"
 #include "chrome/common/importer/imported_bookmark_entry.h"
@@ -40,6 +46,93 @@
 
 using base::Time;
 
+namespace {
+
+// Most of the favicon import is spent decoding the source images, so the
+// favicons of a batch are reencoded on up to this many threads.
+constexpr int kMaxFaviconReencodeThreads = 4;
+
+// Flushes |rows| to the bridge and starts a fresh, bounded batch.
+void FlushHistoryBatch(ImporterBridge* bridge,
+                       std::vector<ImporterURLRow>* rows,
+                       size_t* imported_count) {
+  if (rows->empty())
+    return;
+  *imported_count += rows->size();
+  bridge->SetHistoryItems(*rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
+  rows->clear();
+  VLOG(1) << "Imported " << *imported_count << " history rows";
+}
+
+// A favicon whose image data still has to be reencoded.
+struct PendingFavicon {
+  favicon_base::FaviconUsageData usage;
+  std::vector<unsigned char> data;
+  bool reencoded = false;
+};
+
+// Reencodes a batch of favicons. Every run keeps claiming the next favicon
+// nobody claimed yet, so it can run on several threads at once.
+class FaviconReencoder : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit FaviconReencoder(std::vector<PendingFavicon>* favicons)
+      : favicons_(favicons) {}
+
+  void Run() override {
+    for (size_t i = static_cast<size_t>(next_.GetNext());
+         i < favicons_->size(); i = static_cast<size_t>(next_.GetNext())) {
+      PendingFavicon& favicon = (*favicons_)[i];
+      favicon.reencoded = importer::ReencodeFavicon(
+          &favicon.data[0], favicon.data.size(), &favicon.usage.png_data);
+    }
+  }
+
+ private:
+  std::vector<PendingFavicon>* favicons_;
+  base::AtomicSequenceNumber next_;
+
+  DISALLOW_COPY_AND_ASSIGN(FaviconReencoder);
+};
+
+// Reencodes |pending| in parallel and hands the favicons that could be
+// decoded to the bridge.
+void FlushFaviconBatch(ImporterBridge* bridge,
+                       std::vector<PendingFavicon>* pending,
+                       size_t* imported_count) {
+  if (pending->empty())
+    return;
+
+  FaviconReencoder reencoder(pending);
+  const int thread_count = std::min(
+      {base::SysInfo::NumberOfProcessors(), kMaxFaviconReencodeThreads,
+       static_cast<int>(pending->size())});
+  if (thread_count > 1) {
+    base::DelegateSimpleThreadPool pool("FaviconReencode", thread_count);
+    pool.AddWork(&reencoder, thread_count);
+    pool.Start();
+    pool.JoinAll();
+  } else {
+    reencoder.Run();
+  }
+
+  favicon_base::FaviconUsageDataList favicons;
+  favicons.reserve(pending->size());
+  for (PendingFavicon& favicon : *pending) {
+    // Favicons which couldn't be decoded are skipped.
+    if (favicon.reencoded)
+      favicons.push_back(std::move(favicon.usage));
+  }
+  pending->clear();
+
+  if (favicons.empty())
+    return;
+  *imported_count += favicons.size();
+  bridge->SetFavicons(favicons);
+  VLOG(1) << "Imported " << *imported_count << " favicons";
+}
+
+}  // namespace
+
 ChromeImporter::ChromeImporter() {
 }
 
@@ -102,7 +195,11 @@ void ChromeImporter::ImportHistory() {
   s.BindInt64(3, ui::PAGE_TRANSITION_MANUAL_SUBFRAME);
   s.BindInt64(4, ui::PAGE_TRANSITION_KEYWORD_GENERATED);
 
+  // Rows are streamed to the browser in bounded batches so that neither
+  // process has to hold the whole history of a large profile at once.
   std::vector<ImporterURLRow> rows;
+  rows.reserve(kHistoryBatchSize);
+  size_t imported_count = 0;
   while (s.Step() && !cancelled()) {
     GURL url(s.ColumnString(0));
 
@@ -115,10 +212,12 @@ void ChromeImporter::ImportHistory() {
     row.visit_count = s.ColumnInt(4);
 
     rows.push_back(row);
+    if (rows.size() >= kHistoryBatchSize)
+      FlushHistoryBatch(bridge_.get(), &rows, &imported_count);
   }
 
-  if (!rows.empty() && !cancelled())
-    bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
+  if (!cancelled())
+    FlushHistoryBatch(bridge_.get(), &rows, &imported_count);
 }
 
 void ChromeImporter::ImportBookmarks() {
@@ -177,11 +276,8 @@ void ChromeImporter::ImportBookmarks() {
   FaviconMap favicon_map;
   ImportFaviconURLs(&db, &favicon_map);
   // Write favicons into profile.
-  if (!favicon_map.empty() && !cancelled()) {
-    favicon_base::FaviconUsageDataList favicons;
-    LoadFaviconData(&db, favicon_map, &favicons);
-    bridge_->SetFavicons(favicons);
-  }
+  if (!favicon_map.empty() && !cancelled())
+    LoadFaviconData(&db, favicon_map);
 }
 
 void ChromeImporter::ImportFaviconURLs(
@@ -197,43 +293,53 @@ void ChromeImporter::ImportFaviconURLs(
   }
 }
 
-void ChromeImporter::LoadFaviconData(
-    sql::Database* db,
-    const FaviconMap& favicon_map,
-    favicon_base::FaviconUsageDataList* favicons) {
-  const char query[] = "SELECT f.url, fb.image_data "
+void ChromeImporter::LoadFaviconData(sql::Database* db,
+                                     const FaviconMap& favicon_map) {
+  // Walk all bitmaps in a single pass ordered by icon id instead of issuing
+  // one query per icon; only the first bitmap of each icon is used.
+  const char query[] = "SELECT f.id, f.url, fb.image_data "
                        "FROM favicons f "
                        "JOIN favicon_bitmaps fb "
                        "ON f.id = fb.icon_id "
-                       "WHERE f.id = ?;";
+                       "ORDER BY f.id, fb.id;";
   sql::Statement s(db->GetUniqueStatement(query));
 
   if (!s.is_valid())
     return;
 
-  for (FaviconMap::const_iterator i = favicon_map.begin();
-       i != favicon_map.end(); ++i) {
-    s.BindInt64(0, i->first);
-    if (s.Step()) {
-      favicon_base::FaviconUsageData usage;
-
-      usage.favicon_url = GURL(s.ColumnString(0));
-      if (!usage.favicon_url.is_valid())
-        continue;  // Don't bother importing favicons with invalid URLs.
-
-      std::vector<unsigned char> data;
-      s.ColumnBlobAsVector(1, &data);
-      if (data.empty())
-        continue;  // Data definitely invalid.
-
-      if (!importer::ReencodeFavicon(&data[0], data.size(), &usage.png_data))
-        continue;  // Unable to decode.
-
-      usage.urls = i->second;
-      favicons->push_back(usage);
-    }
-    s.Reset(true);
+  std::vector<PendingFavicon> pending;
+  pending.reserve(kFaviconBatchSize);
+  size_t imported_count = 0;
+  int64_t last_icon_id = -1;
+  bool has_last_icon_id = false;
+  while (s.Step() && !cancelled()) {
+    int64_t icon_id = s.ColumnInt64(0);
+    if (has_last_icon_id && icon_id == last_icon_id)
+      continue;
+    last_icon_id = icon_id;
+    has_last_icon_id = true;
+
+    FaviconMap::const_iterator i = favicon_map.find(icon_id);
+    if (i == favicon_map.end())
+      continue;  // Icon isn't used by any page.
+
+    PendingFavicon favicon;
+    favicon.usage.favicon_url = GURL(s.ColumnString(1));
+    if (!favicon.usage.favicon_url.is_valid())
+      continue;  // Don't bother importing favicons with invalid URLs.
+
+    s.ColumnBlobAsVector(2, &favicon.data);
+    if (favicon.data.empty())
+      continue;  // Data definitely invalid.
+
+    favicon.usage.urls = i->second;
+    pending.push_back(std::move(favicon));
+    if (pending.size() >= kFaviconBatchSize)
+      FlushFaviconBatch(bridge_.get(), &pending, &imported_count);
   }
+
+  if (!cancelled())
+    FlushFaviconBatch(bridge_.get(), &pending, &imported_count);
 }
 
 void ChromeImporter::RecursiveReadBookmarksFolder(
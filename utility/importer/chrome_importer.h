@@ -32,6 +32,11 @@ class Database;
 
 class ChromeImporter : public Importer {
  public:
+  // Maximum number of history rows sent to the bridge in a single call.
+  static constexpr size_t kHistoryBatchSize = 1000;
+  // Maximum number of reencoded favicons sent to the bridge in a single call.
+  static constexpr size_t kFaviconBatchSize = 100;
+
   ChromeImporter();
 
   // Importer:
@@ -63,10 +68,10 @@ class ChromeImporter : public Importer {
     sql::Database* db,
     FaviconMap* favicon_map);
 
-  // Loads and reencodes the individual favicons.
+  // Loads and reencodes the individual favicons, handing them to the bridge
+  // in batches of at most |kFaviconBatchSize|.
   void LoadFaviconData(sql::Database* db,
-                       const FaviconMap& favicon_map,
-                       favicon_base::FaviconUsageDataList* favicons);
+                       const FaviconMap& favicon_map);
 
   void RecursiveReadBookmarksFolder(
     const base::DictionaryValue* folder,
@@ -6,11 +6,13 @@
 #include "brave/utility/importer/chrome_importer.h"
 
 #include <string>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/brave_paths.h"
 #include "chrome/common/chrome_paths.h"
@@ -20,7 +22,11 @@
 #include "chrome/common/importer/mock_importer_bridge.h"
 #include "components/favicon_base/favicon_usage_data.h"
 #include "components/os_crypt/os_crypt_mocker.h"
+#include "sql/database.h"
+#include "sql/statement.h"
+#include "sql/transaction.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "ui/base/page_transition_types.h"
 
 using base::ASCIIToUTF16;
 using base::UTF16ToASCII;
@@ -87,6 +93,73 @@ TEST_F(ChromeImporterTest, ImportHistory) {
   EXPECT_EQ("https://www.nytimes.com/", history[2].url.spec());
 }
 
+TEST_F(ChromeImporterTest, ImportHistoryInBatches) {
+  // Replace the fixture history with one large enough to span several
+  // batches.
+  const size_t kVisitCount = ChromeImporter::kHistoryBatchSize * 2 + 17;
+  base::FilePath history_path = profile_dir_.AppendASCII("History");
+  ASSERT_TRUE(base::DeleteFile(history_path, false));
+  {
+    sql::Database db;
+    ASSERT_TRUE(db.Open(history_path));
+    ASSERT_TRUE(db.Execute(
+        "CREATE TABLE urls(id INTEGER PRIMARY KEY, url LONGVARCHAR, "
+        "title LONGVARCHAR, visit_count INTEGER DEFAULT 0 NOT NULL, "
+        "typed_count INTEGER DEFAULT 0 NOT NULL, "
+        "hidden INTEGER DEFAULT 0 NOT NULL)"));
+    ASSERT_TRUE(db.Execute(
+        "CREATE TABLE visits(id INTEGER PRIMARY KEY, url INTEGER NOT NULL, "
+        "visit_time INTEGER NOT NULL, transition INTEGER DEFAULT 0 NOT NULL)"));
+    sql::Transaction transaction(&db);
+    ASSERT_TRUE(transaction.Begin());
+    sql::Statement url_statement(db.GetUniqueStatement(
+        "INSERT INTO urls(id, url, title, visit_count, typed_count) "
+        "VALUES (?, ?, ?, 1, 0)"));
+    sql::Statement visit_statement(db.GetUniqueStatement(
+        "INSERT INTO visits(url, visit_time, transition) VALUES (?, ?, ?)"));
+    for (size_t i = 0; i < kVisitCount; ++i) {
+      url_statement.BindInt64(0, i + 1);
+      url_statement.BindString(
+          1, base::StringPrintf("https://example%zu.com/", i));
+      url_statement.BindString(2, "Example");
+      ASSERT_TRUE(url_statement.Run());
+      url_statement.Reset(true);
+
+      visit_statement.BindInt64(0, i + 1);
+      visit_statement.BindInt64(1, 13220000000000000 + i);
+      visit_statement.BindInt64(
+          2, ui::PAGE_TRANSITION_LINK | ui::PAGE_TRANSITION_CHAIN_END);
+      ASSERT_TRUE(visit_statement.Run());
+      visit_statement.Reset(true);
+    }
+    ASSERT_TRUE(transaction.Commit());
+  }
+
+  std::vector<size_t> batch_sizes;
+  size_t imported = 0;
+
+  EXPECT_CALL(*bridge_, NotifyStarted());
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::HISTORY));
+  EXPECT_CALL(*bridge_, SetHistoryItems(_, _))
+      .Times(3)
+      .WillRepeatedly(::testing::Invoke(
+          [&](const std::vector<ImporterURLRow>& rows,
+              importer::VisitSource visit_source) {
+            batch_sizes.push_back(rows.size());
+            imported += rows.size();
+          }));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::HISTORY));
+  EXPECT_CALL(*bridge_, NotifyEnded());
+
+  importer_->StartImport(profile_, importer::HISTORY, bridge_.get());
+
+  ASSERT_EQ(3u, batch_sizes.size());
+  EXPECT_EQ(ChromeImporter::kHistoryBatchSize, batch_sizes[0]);
+  EXPECT_EQ(ChromeImporter::kHistoryBatchSize, batch_sizes[1]);
+  EXPECT_EQ(17u, batch_sizes[2]);
+  EXPECT_EQ(kVisitCount, imported);
+}
+
 TEST_F(ChromeImporterTest, ImportBookmarks) {
   std::vector<ImportedBookmarkEntry> bookmarks;
 
@@ -137,6 +210,118 @@ TEST_F(ChromeImporterTest, ImportFavicons) {
             favicons[3].favicon_url.spec());
 }
 
+TEST_F(ChromeImporterTest, ImportFaviconsSkipsUnusedAndInvalidIcons) {
+  // Adds icons next to the fixture ones, reusing the bitmaps of icon 1.
+  {
+    sql::Database db;
+    ASSERT_TRUE(db.Open(profile_dir_.AppendASCII("Favicons")));
+    // Not used by any page.
+    ASSERT_TRUE(db.Execute(
+        "INSERT INTO favicons(id, url) VALUES "
+        "(5, 'https://unused.example.com/favicon.ico')"));
+    // Invalid URL.
+    ASSERT_TRUE(db.Execute(
+        "INSERT INTO favicons(id, url) VALUES (6, 'not a url')"));
+    ASSERT_TRUE(db.Execute(
+        "INSERT INTO favicons(id, url) VALUES "
+        "(7, 'https://example.com/favicon.ico')"));
+    ASSERT_TRUE(db.Execute(
+        "INSERT INTO favicon_bitmaps(icon_id, image_data, width, height) "
+        "SELECT f.id, b.image_data, b.width, b.height "
+        "FROM favicons f, favicon_bitmaps b "
+        "WHERE f.id IN (5, 6, 7) AND b.icon_id = 1"));
+    ASSERT_TRUE(db.Execute(
+        "INSERT INTO icon_mapping(page_url, icon_id) VALUES "
+        "('https://invalid.example.com/', 6), "
+        "('https://example.com/', 7), "
+        "('https://example.com/page', 7)"));
+  }
+
+  favicon_base::FaviconUsageDataList favicons;
+
+  EXPECT_CALL(*bridge_, NotifyStarted());
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::FAVORITES));
+  EXPECT_CALL(*bridge_, SetFavicons(_))
+      .WillOnce(::testing::SaveArg<0>(&favicons));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::FAVORITES));
+  EXPECT_CALL(*bridge_, NotifyEnded());
+
+  importer_->StartImport(profile_, importer::FAVORITES, bridge_.get());
+
+  // Every icon is imported once, even though it has several bitmaps.
+  ASSERT_EQ(5u, favicons.size());
+  EXPECT_EQ("https://static.nytimes.com/favicon.ico",
+            favicons[3].favicon_url.spec());
+  EXPECT_EQ(2u, favicons[3].urls.size());
+  EXPECT_EQ("https://example.com/favicon.ico",
+            favicons[4].favicon_url.spec());
+  EXPECT_EQ(2u, favicons[4].urls.size());
+  EXPECT_FALSE(favicons[4].png_data.empty());
+}
+
+TEST_F(ChromeImporterTest, ImportFaviconsInBatches) {
+  // Adds enough icons next to the 4 fixture ones to span several batches,
+  // reusing the bitmaps of icon 1.
+  const size_t kExtraIconCount = ChromeImporter::kFaviconBatchSize * 2 + 3;
+  {
+    sql::Database db;
+    ASSERT_TRUE(db.Open(profile_dir_.AppendASCII("Favicons")));
+    sql::Transaction transaction(&db);
+    ASSERT_TRUE(transaction.Begin());
+    sql::Statement icon_statement(db.GetUniqueStatement(
+        "INSERT INTO favicons(id, url) VALUES (?, ?)"));
+    sql::Statement mapping_statement(db.GetUniqueStatement(
+        "INSERT INTO icon_mapping(page_url, icon_id) VALUES (?, ?)"));
+    for (size_t i = 0; i < kExtraIconCount; ++i) {
+      const int64_t icon_id = 100 + i;
+      icon_statement.BindInt64(0, icon_id);
+      icon_statement.BindString(
+          1, base::StringPrintf("https://example%zu.com/favicon.ico", i));
+      ASSERT_TRUE(icon_statement.Run());
+      icon_statement.Reset(true);
+
+      mapping_statement.BindString(
+          0, base::StringPrintf("https://example%zu.com/", i));
+      mapping_statement.BindInt64(1, icon_id);
+      ASSERT_TRUE(mapping_statement.Run());
+      mapping_statement.Reset(true);
+    }
+    ASSERT_TRUE(db.Execute(
+        "INSERT INTO favicon_bitmaps(icon_id, image_data, width, height) "
+        "SELECT f.id, b.image_data, b.width, b.height "
+        "FROM favicons f, favicon_bitmaps b "
+        "WHERE f.id >= 100 AND b.icon_id = 1"));
+    ASSERT_TRUE(transaction.Commit());
+  }
+
+  std::vector<size_t> batch_sizes;
+  size_t imported = 0;
+  bool all_reencoded = true;
+
+  EXPECT_CALL(*bridge_, NotifyStarted());
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::FAVORITES));
+  EXPECT_CALL(*bridge_, SetFavicons(_))
+      .Times(3)
+      .WillRepeatedly(::testing::Invoke(
+          [&](const favicon_base::FaviconUsageDataList& favicons) {
+            batch_sizes.push_back(favicons.size());
+            imported += favicons.size();
+            for (const auto& favicon : favicons)
+              all_reencoded &= !favicon.png_data.empty();
+          }));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::FAVORITES));
+  EXPECT_CALL(*bridge_, NotifyEnded());
+
+  importer_->StartImport(profile_, importer::FAVORITES, bridge_.get());
+
+  ASSERT_EQ(3u, batch_sizes.size());
+  EXPECT_EQ(ChromeImporter::kFaviconBatchSize, batch_sizes[0]);
+  EXPECT_EQ(ChromeImporter::kFaviconBatchSize, batch_sizes[1]);
+  EXPECT_EQ(7u, batch_sizes[2]);
+  EXPECT_EQ(kExtraIconCount + 4, imported);
+  EXPECT_TRUE(all_reencoded);
+}
+
 // The mock keychain only works on macOS, so only run this test on macOS (for
 // now)
 #if defined(OS_MACOSX)